@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Demo applikation
- * Version: 1.1
+ * Version: 1.8
  * Type: Program
  * Programmeret af: Jan Birch
- * Opdateret: 05-04-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Demo applikation".
  * 
@@ -23,6 +23,13 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.2: Drivere og mediator afvikles af opgavestyring. Lyssensoren læses hvert 100 msek.
+ * Version 1.3: Digitale indgange læses via port registre.
+ * Version 1.4: Analoge indgange skannes med interrupt. Læsning af lyssensoren venter ikke længere på A/D konverteren.
+ * Version 1.5: Lyssensorens indgang glattes af filteret i den analoge driver.
+ * Version 1.6: Udgange skrives i skyggeregistre og udlæses samlet sidst i hvert taktslag.
+ * Version 1.7: Flankedetektorer er oversatte kæder i knapperne.
+ * Version 1.8: Lyssensoren skannes med interrupt, som vælges med JB_ADC_SCAN.
  */
 
 #include <JBKernel.h>
@@ -32,20 +39,21 @@ const unsigned int MaxNoInParrPorts =3;
 enum {RumlysVPort, LedelysPort, RumlysHPort};
 enum {RumlysVPin=2, LedelysPin=3, RumlysHPin=4};
 #include <JBInputDriver.h>
-t_DigitalParrInDrv digitalParrInDrv;
+t_DigitalPortRegInDrv digitalParrInDrv;
 
 const unsigned int MaxNoInAnlPorts =1;
 enum {LyssensorPort};
 enum {LyssensorPin=A0};
+#define JB_ADC_SCAN
 #include <JBAnalogInDriver.h>
-t_AnalogParrInDrv analogParrInDrv;
+t_AnalogScanInDrv analogParrInDrv;
 
 // Erklæring af output porte
 const unsigned int MaxNoOutParrPorts = 2;
 enum {LedelampePort, RumlamperPort};
 enum {LedelampePin=7, RumlamperPin=8};
 #include <JBOutputDriver.h>
-t_DigitalParrOutDrv digitalParrOutDrv;
+t_DigitalPortRegOutDrv digitalParrOutDrv;
 
 // Erklæring af manuelle betjeninger
 const unsigned int MaxNoManuals = 3;
@@ -55,11 +63,8 @@ t_Button rumKnapVButton;
 t_Button ledelysButton;
 t_Button rumKnapHButton;
 
-// Erklæring af flankedetektorer
+// Flankedetektorer bygges som oversatte kæder i knapperne
 #include <JBDigitalFunctions.h>
-t_EdgeDetector rumKnapVFlankDet;
-t_EdgeDetector ledelysFlankDet;
-t_EdgeDetector rumKnapHFlankDet;
 
 // Erklæring af sensorer
 const unsigned int MaxNoSensors = 1;
@@ -92,6 +97,14 @@ t_LedelysManState ledelysManState;
 t_LedelysAutState ledelysAutState;
 t_LedelysOffState ledelysOffState;
 
+// Erklæring af opgaver. Kontakter læses hvert taktslag, lyssensoren hvert 100 msek. Udgange udlæses sidst i hvert taktslag.
+const unsigned int MaxNoTasks = 4;
+#include <JBScheduler.h>
+void readDigitalInputs(void) {digitalParrInDrv.doClockCycle();}
+void readAnalogInputs(void) {analogParrInDrv.doClockCycle();}
+void runMediator(void) {demoApp.doClockCycle();}
+void writeDigitalOutputs(void) {digitalParrOutDrv.doClockCycle();}
+
 //----------
 
 void setup() {
@@ -100,6 +113,7 @@ void setup() {
   digitalParrInDrv.setPort(LedelysPort, LedelysPin, NOPEN, EXTERN_PULLUP, BOUNCE_FILTER);
   digitalParrInDrv.setPort(RumlysHPort, RumlysHPin, NCLOSED, EXTERN_PULLUP, BOUNCE_FILTER);
   analogParrInDrv.setPort(LyssensorPort, LyssensorPin);
+  analogParrInDrv.setFilter(LyssensorPort, 6);
 // Opsætning af output porte
   digitalParrOutDrv.setPort(LedelampePort, LedelampePin);
   digitalParrOutDrv.setPort(RumlamperPort, RumlamperPin);
@@ -108,12 +122,13 @@ void setup() {
   ledelysButton.begin(&digitalParrInDrv, LedelysPort);
   rumKnapHButton.begin(&digitalParrInDrv, RumlysHPort);
 // Opsætning af flankedetektorer
-  rumKnapVFlankDet.begin(ON, EDGEDOWN);
-  ledelysFlankDet.begin(OFF, EDGEUP);
-  rumKnapHFlankDet.begin(ON, EDGEDOWN);
-  rumKnapVButton.setDigitalFunction(&rumKnapVFlankDet);
-  ledelysButton.setDigitalFunction(&ledelysFlankDet);
-  rumKnapHButton.setDigitalFunction(&rumKnapHFlankDet);
+  t_FunctionChain faldendeFlanke;
+  t_FunctionChain stigendeFlanke;
+  faldendeFlanke.add(FCT_EDGEDOWN, ON);
+  stigendeFlanke.add(FCT_EDGEUP, OFF);
+  rumKnapVButton.setDigitalFunction(faldendeFlanke);
+  ledelysButton.setDigitalFunction(stigendeFlanke);
+  rumKnapHButton.setDigitalFunction(faldendeFlanke);
 // Opsætning af sensor
   ledelysSensor.begin(&analogParrInDrv, LyssensorPort);
 // Opsætning af styrenheder
@@ -125,13 +140,16 @@ void setup() {
   collection.ctrlUnits[LedelysLamper] = &ledelysLamperOut; collection.ctrlUnits[RumLamper] = &rumLamperOut;
   collection.states[Hvile] = &hvileState; collection.states[RumlysOn] = &rumlysOnState; collection.states[LedelysManuel] = &ledelysManState;
   collection.states[LedelysAut] = &ledelysAutState; collection.states[LedelysOff] = &ledelysOffState;
+// Opsætning af opgaver. Rækkefølgen giver indlæsning før mediator og udlæsning efter.
+  Scheduler::addTask(readDigitalInputs, 5);
+  Scheduler::addTask(readAnalogInputs, 100);
+  Scheduler::addTask(runMediator, 5);
+  Scheduler::addTask(writeDigitalOutputs, 5);
 // Start applikation
   demoApp.begin(Hvile);
 }
 
 void loop() {
   Clock::pendulum();
-  digitalParrInDrv.doClockCycle();
-  analogParrInDrv.doClockCycle();
-  demoApp.doClockCycle();
+  Scheduler::doClockCycle();
 }
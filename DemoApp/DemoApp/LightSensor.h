@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Lyssensor
- * Version: 1.0
+ * Version: 1.1
  * Type: Program
  * Programmeret af: Jan Birch
- * Opdateret: 14-03-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Lyssensor".
  * 
@@ -23,6 +23,7 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Lyssensor sammenligner med hysterese i stedet for et enkelt niveau.
  */
 
 #ifndef LightSensor_h
@@ -31,24 +32,11 @@
 #include <Arduino.h>
 #include <JBKernel.h>
 
-// Ansvar: Varetager lyssensor
-// doClockCycle(...): Læser input og opdaterer status.
-class t_LightSensor: public t_Sensor {
-private:
-  const int treshold = 650;
+// Ansvar: Varetager lyssensor. Tænder i skumring under 600 og slukker ved daggry over 700.
+// Hysterese omkring det tidligere niveau 650 forhindrer at ledelyset blinker, mens lyset skifter.
+class t_LightSensor: public t_HysteresisSensor {
 public:
-  t_LightSensor(void) {}
-  void doClockCycle(void);
+  t_LightSensor(void): t_HysteresisSensor(600, 700) {}
 };
 
-/*
- * CPP kode herunder
- */
-
-void t_LightSensor::doClockCycle(void) {
-  if (driver == nullptr) return;
-  int analogValue;
-  driver->read(portNo, &analogValue);
-  state = (analogValue < treshold)? ON: OFF;
-}
 #endif
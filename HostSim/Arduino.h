@@ -0,0 +1,389 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af Arduino på PC
+ * Version: 1.6
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af Arduino på PC".
+ *
+ * "Simulering af Arduino på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af Arduino på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af Arduino på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter Arduino.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * Tiden er virtuel. Den går kun frem, når simuleringen beder om det, og derfor kører en times
+ * anlæg på en brøkdel af et sekund. Pins er modelleret som på Arduino Uno.
+ * Version 1.1: Pin change interrupt. Påvirkninger kan ske mellem cyklusser på det tidspunkt scenariet angiver.
+ * Version 1.2: A/D konverter med interrupt.
+ * Version 1.3: Kald til modeller af kredse, når en output pin skifter niveau.
+ * Version 1.4: Funktioner til bytes i et word.
+ * Version 1.5: Timer 2 i CTC med interrupt.
+ * Version 1.6: Data i program memory med PROGMEM og pgm_read, som på Arduino.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+// Kendetegner at koden bygges til simulering
+#define ARDUINO_HOSTSIM
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+// Bytes i et word som på Arduino
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+inline word makeWord(word w) {return w;}
+inline word makeWord(byte h, byte l) {return (h << 8) | l;}
+#define word(...) makeWord(__VA_ARGS__)
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// Pins som på Arduino Uno. A6 og A7 er kun analoge.
+#define NUM_DIGITAL_PINS 20
+#define NUM_ANALOG_INPUTS 8
+#define NUM_PINS 22
+enum {A0=14, A1, A2, A3, A4, A5, A6, A7};
+
+// Porte som på Arduino Uno. Pin 0-7 er port D, pin 8-13 er port B og pin 14-19 er port C.
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+#define NUM_PORTS 5
+#define digitalPinToPort(P) (((P) < 8)? PD: ((P) < 14)? PB: ((P) < NUM_DIGITAL_PINS)? PC: NOT_A_PORT)
+#define digitalPinToBitMask(P) ((byte)(1 << (((P) < 8)? (P): ((P) < 14)? (P)-8: (P)-14)))
+#define portInputRegister(P) (&HostSim::pinRegs[(P)])
+#define portOutputRegister(P) (&HostSim::portRegs[(P)])
+#define portModeRegister(P) (&HostSim::ddrRegs[(P)])
+#define PINB HostSim::pinRegs[PB]
+#define PINC HostSim::pinRegs[PC]
+#define PIND HostSim::pinRegs[PD]
+#define PORTB HostSim::portRegs[PB]
+#define PORTC HostSim::portRegs[PC]
+#define PORTD HostSim::portRegs[PD]
+#define DDRB HostSim::ddrRegs[PB]
+#define DDRC HostSim::ddrRegs[PC]
+#define DDRD HostSim::ddrRegs[PD]
+
+// Pin change interrupt som på Arduino Uno. Gruppe 0 er port B, gruppe 1 er port C og gruppe 2 er port D.
+#define PCICR HostSim::pcicr
+#define PCMSK0 HostSim::pcmsk[0]
+#define PCMSK1 HostSim::pcmsk[1]
+#define PCMSK2 HostSim::pcmsk[2]
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define digitalPinToPCICR(P) (((P) < NUM_DIGITAL_PINS)? (&PCICR): ((volatile byte *)0))
+#define digitalPinToPCICRbit(P) (((P) < 8)? 2: ((P) < 14)? 0: 1)
+#define digitalPinToPCMSK(P) (((P) < 8)? (&PCMSK2): ((P) < 14)? (&PCMSK0): ((P) < NUM_DIGITAL_PINS)? (&PCMSK1): ((volatile byte *)0))
+#define digitalPinToPCMSKbit(P) (((P) < 8)? (P): ((P) < 14)? (P)-8: (P)-14)
+
+// A/D konverter som på Arduino Uno
+#define ADMUX HostSim::admux
+#define ADCSRA HostSim::adcsra
+#define ADCSRB HostSim::adcsrb
+#define ADC HostSim::adc
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+// Timer 2 som på Arduino Uno. Kun CTC med interrupt ved compare match A er med.
+#define TCCR2A HostSim::tccr2a
+#define TCCR2B HostSim::tccr2b
+#define TCNT2 HostSim::tcnt2
+#define OCR2A HostSim::ocr2a
+#define TIMSK2 HostSim::timsk2
+#define WGM20 0
+#define WGM21 1
+#define WGM22 3
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define OCIE2A 1
+
+#define constrain(amt, low, high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+// Ansvar: Virtuel Arduino med ur og pins.
+// Pins er modelleret med port registre som på Arduino. Program og biblioteker kan derfor både bruge
+// digitalRead/digitalWrite og læse og skrive registrene direkte.
+// microsNow: Virtuel tid i mikrosekunder.
+// ddrRegs, portRegs, pinRegs: Port registre for retning, udgang/pullup og indgang.
+// isDriven: Om omverdenen påtrykker en pin et niveau. Bitmaske per port.
+// extLevel: Niveau som omverdenen påtrykker. Bitmaske per port.
+// lastOut: Seneste niveau på udgange. Bruges til sporing.
+// analogValue: Spænding på analoge indgange, 0-1023.
+// pcicr, pcmsk: Registre for pin change interrupt.
+// admux, adcsra, adcsrb, adc: Registre for A/D konverter.
+// AdcConversionTime: Tid for en konvertering i mikrosek. 13 cyklus med prescaler 128 ved 16 MHz.
+// isConverting, conversionEnd: Om en konvertering er i gang og hvornår den slutter.
+// tccr2a, tccr2b, tcnt2, ocr2a, timsk2: Registre for timer 2.
+// isTimer2Running, timer2Match: Om timer 2 tæller og tidspunktet for næste compare match i CPU cyklus á 1/16 mikrosek.
+// onPinChange: Kaldes når en output pin skifter niveau. Bruges til sporing.
+// onDevicePin: Kaldes når en output pin skifter niveau. Bruges af modeller af kredse, der er koblet til pins.
+// stimulus: Kaldes før tiden går frem med tidspunktet i mikrosek, tiden går frem til. Påvirker pins på det rigtige tidspunkt.
+// sync(...): Opdaterer input registre, sporer udgange og kalder pin change interrupt. Kaldes når tiden går og når pins påvirkes.
+// pinChangeInterrupt(...): Kalder interrupt rutine for en gruppe af pin change interrupt.
+// convert(...): Udfører konverteringer, der slutter før et tidspunkt i mikrosek, og kalder interrupt rutine for A/D konverter.
+// countTimer2(...): Tæller timer 2 frem til et tidspunkt i mikrosek og kalder interrupt rutine ved hvert compare match.
+// elapse(...): Lader tiden gå frem til et tidspunkt i mikrosek. Påvirkninger og konverteringer undervejs udføres.
+// advance(...): Lader tiden gå frem.
+// idleUntil(...): Lader tiden gå frem til et bestemt tidspunkt i msek. Erstatter aktiv venten.
+// setPin(...): Påtrykker en pin et niveau.
+// releasePin(...): Fjerner påtrykt niveau.
+// setAnalog(...): Sætter spænding på analog indgang.
+// pinOut(...): Leverer niveau på en output pin.
+namespace HostSim {
+  unsigned long microsNow=0;
+  volatile byte ddrRegs[NUM_PORTS];
+  volatile byte portRegs[NUM_PORTS];
+  volatile byte pinRegs[NUM_PORTS];
+  byte isDriven[NUM_PORTS];
+  byte extLevel[NUM_PORTS];
+  byte lastOut[NUM_PORTS];
+  int analogValue[NUM_ANALOG_INPUTS];
+  volatile byte pcicr=0;
+  volatile byte pcmsk[3];
+  volatile byte admux=0;
+  volatile byte adcsra=0;
+  volatile byte adcsrb=0;
+  volatile word adc=0;
+  const unsigned long AdcConversionTime=104;
+  bool isConverting=false;
+  unsigned long conversionEnd;
+  volatile byte tccr2a=0;
+  volatile byte tccr2b=0;
+  volatile byte tcnt2=0;
+  volatile byte ocr2a=0;
+  volatile byte timsk2=0;
+  bool isTimer2Running=false;
+  unsigned long long timer2Match;
+  void (*onPinChange)(byte pin, byte level)=nullptr;
+  void (*onDevicePin)(byte pin, byte level)=nullptr;
+  void (*stimulus)(unsigned long us)=nullptr;
+  void sync(void);
+  void pinChangeInterrupt(byte group);
+  void convert(unsigned long us);
+  void countTimer2(unsigned long us);
+  void elapse(unsigned long us);
+  void advance(unsigned long us);
+  void idleUntil(unsigned long ms);
+  void setPin(byte pin, byte level);
+  void releasePin(byte pin);
+  void setAnalog(byte pin, int value);
+  byte pinOut(byte pin);
+}
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(byte pin, byte mode);
+int digitalRead(byte pin);
+void digitalWrite(byte pin, byte value);
+int analogRead(byte pin);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+/*
+ * CPP kode herunder
+ */
+
+// Udgange giver registrets værdi. Indgange giver påtrykt niveau. Uden påtrykt niveau trækker pullup højt og ellers er indgangen lav.
+// Skift på en pin med pin change interrupt kalder gruppens interrupt rutine, når alle registre er opdateret.
+void HostSim::sync(void) {
+  byte groups = 0;
+  for (byte port=PB; port < NUM_PORTS; port++) {
+    byte output = ddrRegs[port];
+    byte external = isDriven[port] & ~output;
+    byte lastIn = pinRegs[port];
+    byte group = port-PB;
+    pinRegs[port] = (portRegs[port] & (output | ~isDriven[port])) | (extLevel[port] & external);
+    if (((pinRegs[port] ^ lastIn) & pcmsk[group]) != 0) groups |= 1 << group;
+    byte changed = (portRegs[port] ^ lastOut[port]) & output;
+    lastOut[port] = (lastOut[port] & ~output) | (portRegs[port] & output);
+    if ((changed == 0) || ((onPinChange == nullptr) && (onDevicePin == nullptr))) continue;
+    for (byte pin=0; pin < NUM_DIGITAL_PINS; pin++) {
+      if ((digitalPinToPort(pin) == port) && ((changed & digitalPinToBitMask(pin)) != 0)) {
+        byte level = ((portRegs[port] & digitalPinToBitMask(pin)) != 0)? HIGH: LOW;
+        if (onDevicePin != nullptr) onDevicePin(pin, level);
+        if (onPinChange != nullptr) onPinChange(pin, level);
+      }
+    }
+  }
+  groups &= pcicr;
+  for (byte group=0; group < 3; group++) {
+    if ((groups & (1 << group)) != 0) pinChangeInterrupt(group);
+  }
+}
+
+void HostSim::pinChangeInterrupt(byte group) {
+  void (*vector)(void) = (group == 0)? PCINT0_vect: (group == 1)? PCINT1_vect: PCINT2_vect;
+  if (vector != nullptr) vector();
+}
+
+// En konvertering starter, når ADSC ses sat, og slutter AdcConversionTime senere. Interrupt rutinen kan starte den næste.
+void HostSim::convert(unsigned long us) {
+  while (((adcsra & (1 << ADEN)) != 0) && ((adcsra & (1 << ADSC)) != 0)) {
+    if (isConverting == false) {
+      isConverting = true;
+      conversionEnd = microsNow+AdcConversionTime;
+    }
+    if (conversionEnd > us) return;
+    if (microsNow < conversionEnd) microsNow = conversionEnd;
+    isConverting = false;
+    adc = analogValue[admux & 0x07];
+    adcsra &= ~(1 << ADSC);
+    if ((adcsra & (1 << ADIE)) == 0) adcsra |= 1 << ADIF;
+    else if (ADC_vect != nullptr) ADC_vect();
+  }
+}
+
+// Interrupt rutinen kan sætte OCR2A for den periode, der netop er startet, som i CTC på Arduino.
+// Udgange som rutinen ændrer, spores på tidspunktet for compare match.
+void HostSim::countTimer2(unsigned long us) {
+  static const unsigned int prescalers[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+  while (((tccr2a & (1 << WGM21)) != 0) && ((tccr2b & 0x07) != 0) && ((timsk2 & (1 << OCIE2A)) != 0)) {
+    if (isTimer2Running == false) {
+      isTimer2Running = true;
+      timer2Match = (unsigned long long)microsNow*16+(ocr2a+1)*prescalers[tccr2b & 0x07];
+    }
+    if (timer2Match > (unsigned long long)us*16) return;
+    if (microsNow < timer2Match/16) microsNow = timer2Match/16;
+    tcnt2 = 0;
+    if (TIMER2_COMPA_vect != nullptr) TIMER2_COMPA_vect();
+    sync();
+    timer2Match += (ocr2a+1)*prescalers[tccr2b & 0x07];
+  }
+  isTimer2Running = false;
+}
+
+void HostSim::elapse(unsigned long us) {
+  sync();
+  if (stimulus != nullptr) stimulus(us);
+  convert(us);
+  countTimer2(us);
+  microsNow = us;
+}
+
+void HostSim::advance(unsigned long us) {
+  elapse(microsNow+us);
+}
+
+void HostSim::idleUntil(unsigned long ms) {
+  if (microsNow < ms*1000) elapse(ms*1000);
+  else sync();
+}
+
+void HostSim::setPin(byte pin, byte level) {
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT) return;
+  byte mask = digitalPinToBitMask(pin);
+  isDriven[port] |= mask;
+  extLevel[port] = (level == LOW)? (extLevel[port] & ~mask): (extLevel[port] | mask);
+  sync();
+}
+
+void HostSim::releasePin(byte pin) {
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT) return;
+  isDriven[port] &= ~digitalPinToBitMask(pin);
+  sync();
+}
+
+void HostSim::setAnalog(byte pin, int value) {
+  if (pin >= A0) pin = pin-A0;
+  if (pin < NUM_ANALOG_INPUTS) analogValue[pin] = constrain(value, 0, 1023);
+}
+
+byte HostSim::pinOut(byte pin) {
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT) return LOW;
+  return ((portRegs[port] & digitalPinToBitMask(pin)) != 0)? HIGH: LOW;
+}
+
+//----------
+
+unsigned long millis(void) {
+  return HostSim::microsNow/1000;
+}
+
+unsigned long micros(void) {
+  return HostSim::microsNow;
+}
+
+void delay(unsigned long ms) {
+  HostSim::advance(ms*1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  HostSim::advance(us);
+}
+
+void pinMode(byte pin, byte mode) {
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT) return;
+  byte mask = digitalPinToBitMask(pin);
+  if (mode == OUTPUT) HostSim::ddrRegs[port] |= mask;
+  else {
+    HostSim::ddrRegs[port] &= ~mask;
+    if (mode == INPUT_PULLUP) HostSim::portRegs[port] |= mask;
+    else HostSim::portRegs[port] &= ~mask;
+  }
+  HostSim::sync();
+}
+
+int digitalRead(byte pin) {
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT) return LOW;
+  return ((HostSim::pinRegs[port] & digitalPinToBitMask(pin)) != 0)? HIGH: LOW;
+}
+
+void digitalWrite(byte pin, byte value) {
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT) return;
+  if (value == LOW) HostSim::portRegs[port] &= ~digitalPinToBitMask(pin);
+  else HostSim::portRegs[port] |= digitalPinToBitMask(pin);
+  HostSim::sync();
+}
+
+int analogRead(byte pin) {
+  if (pin >= A0) pin = pin-A0;
+  return (pin < NUM_ANALOG_INPUTS)? HostSim::analogValue[pin]: 0;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af applikation på PC
+ * Version: 1.2
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af applikation på PC".
+ *
+ * "Simulering af applikation på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af applikation på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af applikation på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Bygger en Arduino applikation til PC og afvikler den i virtuel tid.
+ * Applikationens .ino fil inkluderes direkte, ligesom Arduino udviklingsmiljøet gør. Se Makefile.
+ * Kald: <program> [sekunder] [scenarie]
+ * Et scenarie er en tekstfil med påvirkninger af indgange. Hver linje har formatet: <msek> <pin> <værdi>
+ * Pin A0-A7 er analog og værdi er 0-1023. Øvrige pins er digitale og værdi er 0, 1 eller - for at fjerne påvirkning.
+ * Pin "load" simulerer programmets gennemløbstid. Værdi er msek per cyklus.
+ * Pin "sleep" slår dvale mellem taktslag til med 1 og fra med 0.
+ * Linjer der starter med # er kommentarer.
+ * Version 1.1: Påvirkninger udføres på det tidspunkt scenariet angiver, også mellem cyklusser.
+ * Version 1.2: En test afslutter med fejl, hvis en kontrol fejler.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <time.h>
+#include APP_INO
+
+// Ansvar: Afvikler applikationen og påvirker indgange efter et scenarie.
+// MaxNoEvents: Største antal påvirkninger i et scenarie
+// t_Event: En påvirkning af en indgang
+// events: Scenariets påvirkninger sorteret efter tid
+// loadScenario(...): Indlæser scenarie fra fil
+// loadTime: Simuleret gennemløbstid i msek per cyklus
+// apply(...): Udfører en påvirkning
+// applyEvents(...): Udfører påvirkninger, hvis tid er nået
+// applyUntil(...): Udfører påvirkninger før et tidspunkt i mikrosek, hver på sit tidspunkt. Kaldes når tiden går frem.
+// tracePin(...): Udskriver skift på output pins. En test kontrollerer selv sine pins, så skift udskrives ikke.
+namespace HostMain {
+  const unsigned int MaxNoEvents = 256;
+  struct t_Event {
+    unsigned long time;
+    byte pin;
+    bool isAnalog;
+    bool isLoad;
+    bool isSleep;
+    bool release;
+    int value;
+  };
+  t_Event events[MaxNoEvents];
+  unsigned int noEvents = 0;
+  unsigned int nextEvent = 0;
+  unsigned long loadTime = 0;
+  bool loadScenario(const char *fileName);
+  void apply(const t_Event &event);
+  void applyEvents(void);
+  void applyUntil(unsigned long us);
+  void tracePin(byte pin, byte level);
+}
+
+/*
+ * CPP kode herunder
+ */
+
+bool HostMain::loadScenario(const char *fileName) {
+  FILE *file = fopen(fileName, "r");
+  if (file == nullptr) return false;
+  char line[128];
+  while ((fgets(line, sizeof(line), file) != nullptr) && (noEvents < MaxNoEvents)) {
+    unsigned long time;
+    char pinText[8], valueText[8];
+    if ((line[0] == '#') || (sscanf(line, "%lu %7s %7s", &time, pinText, valueText) != 3)) continue;
+    unsigned int pos = noEvents;  // Indsættes sorteret efter tid
+    while ((pos > 0) && (events[pos-1].time > time)) {
+      events[pos] = events[pos-1];
+      pos--;
+    }
+    t_Event &event = events[pos];
+    event.time = time;
+    event.isAnalog = (pinText[0] == 'A');
+    event.isLoad = (strcmp(pinText, "load") == 0);
+    event.isSleep = (strcmp(pinText, "sleep") == 0);
+    event.pin = (event.isAnalog == true)? A0+atoi(pinText+1): atoi(pinText);
+    event.release = (valueText[0] == '-');
+    event.value = atoi(valueText);
+    noEvents++;
+  }
+  fclose(file);
+  return true;
+}
+
+void HostMain::apply(const t_Event &event) {
+  if (event.isLoad == true) loadTime = event.value;
+#ifdef JBKernel_h
+  else if (event.isSleep == true) Clock::IdleSleep = (event.value != 0);
+#endif
+  else if (event.isAnalog == true) HostSim::setAnalog(event.pin, event.value);
+  else if (event.release == true) HostSim::releasePin(event.pin);
+  else HostSim::setPin(event.pin, event.value);
+}
+
+void HostMain::applyEvents(void) {
+  while ((nextEvent < noEvents) && (events[nextEvent].time <= millis())) apply(events[nextEvent++]);
+}
+
+// Tiden stilles frem til påvirkningen, så interrupt rutiner ser det rigtige tidspunkt.
+void HostMain::applyUntil(unsigned long us) {
+  while ((nextEvent < noEvents) && (events[nextEvent].time*1000 < us)) {
+    t_Event &event = events[nextEvent++];
+    if (HostSim::microsNow < event.time*1000) HostSim::microsNow = event.time*1000;
+    apply(event);
+  }
+}
+
+void HostMain::tracePin(byte pin, byte level) {
+  printf("%10.3f s  pin %2u %s\n", millis()/1000.0, pin, (level == HIGH)? "HIGH": "LOW");
+}
+
+//----------
+
+int main(int argc, char *argv[]) {
+  unsigned long seconds = (argc > 1)? strtoul(argv[1], nullptr, 10): 3600;
+  if ((argc > 2) && (HostMain::loadScenario(argv[2]) == false)) {
+    fprintf(stderr, "Kan ikke læse scenarie: %s\n", argv[2]);
+    return 1;
+  }
+  clock_t wallStart = clock();
+  unsigned long noCycles = 0;
+  HostMain::applyEvents();
+  setup();
+#ifndef HostSim_HostTest_h
+  HostSim::onPinChange = HostMain::tracePin;
+#endif
+  HostSim::stimulus = HostMain::applyUntil;
+  while (millis() < seconds*1000) {
+    HostMain::applyEvents();
+    loop();
+    HostSim::advance(HostMain::loadTime*1000);
+    noCycles++;
+  }
+  double wallTime = double(clock()-wallStart)/CLOCKS_PER_SEC;
+  printf("Simuleret tid: %lu s, cyklusser: %lu, tid brugt: %.3f s\n", seconds, noCycles, wallTime);
+#ifdef JBKernel_h
+  printf("Længste gennemløb: %u msek, tabte taktslag: %u, ledig tid: %u/%u/%u/%u\n", Clock::stats.maxBodyTime, Clock::stats.missedCycles,
+    Clock::stats.slack[0], Clock::stats.slack[1], Clock::stats.slack[2], Clock::stats.slack[3]);
+#endif
+#ifdef HostSim_sleep_h
+  printf("Opvågninger fra dvale: %lu\n", HostSim::noWakeups);
+#endif
+#ifdef HostSim_HostTest_h
+  printf("Test: %lu kontroller, %lu fejl\n", HostTest::noChecks, HostTest::noFailures);
+  if ((HostTest::noFailures > 0) || (HostTest::noChecks == 0)) return 1;
+#endif
+  return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af applikation på PC
+ * Version: 1.0
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af applikation på PC".
+ *
+ * "Test af applikation på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af applikation på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af applikation på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * En test er en applikation i Tests/<navn>/<navn>.ino med et scenarie i samme mappe. Se Makefile.
+ * Testen inkluderer denne fil og kontrollerer bibliotekernes opførsel med check.
+ * HostMain udskriver resultatet og afslutter med fejl, hvis en kontrol fejler, eller hvis ingen kontrol er udført.
+ */
+
+#ifndef HostSim_HostTest_h
+#define HostSim_HostTest_h
+
+#include <Arduino.h>
+#include <stdio.h>
+
+// Ansvar: Kontroller i en test.
+// noChecks: Antal udførte kontroller
+// noFailures: Antal kontroller der fejlede
+// check(...): Udfører en kontrol. Udskriver tid og tekst, hvis betingelsen ikke er opfyldt.
+namespace HostTest {
+  unsigned long noChecks=0;
+  unsigned long noFailures=0;
+  void check(bool condition, const char *text);
+}
+
+/*
+ * CPP kode herunder
+ */
+
+void HostTest::check(bool condition, const char *text) {
+  noChecks++;
+  if (condition == true) return;
+  noFailures++;
+  printf("%10.3f s  FEJL: %s\n", millis()/1000.0, text);
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af SPI på PC
+ * Version: 1.2
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af SPI på PC".
+ *
+ * "Simulering af SPI på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af SPI på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af SPI på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter SPI.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * Kredse på bussen modelleres af applikationen eller testen med onSpiTransfer og HostSim::onDevicePin.
+ * Version 1.1: Advarsler fra compileren er rettet.
+ * Version 1.2: Rækkefølge af bits er med i overførslen, så modeller af skifteregistre kan kontrollere den.
+ */
+
+#ifndef HostSim_SPI_h
+#define HostSim_SPI_h
+
+#include <Arduino.h>
+
+#ifndef LSBFIRST
+#define LSBFIRST 0
+#define MSBFIRST 1
+#endif
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+// Ansvar: Virtuel SPI bus.
+// onSpiTransfer: Model af kredse på bussen. Modtager byte fra Arduino og leverer byte til Arduino.
+// noSpiBytes: Antal overførte bytes. Bruges til at måle trafik på bussen.
+// spiBitOrder: Rækkefølge af bits i den igangværende overførsel. En model af kredse skifter bits i denne rækkefølge.
+namespace HostSim {
+  byte (*onSpiTransfer)(byte data)=nullptr;
+  unsigned long noSpiBytes=0;
+  uint8_t spiBitOrder=MSBFIRST;
+}
+
+// Ansvar: Indstillinger for en overførsel. Kun rækkefølgen af bits har betydning i simuleringen.
+// bitOrder: Rækkefølge af bits
+class SPISettings {
+public:
+  uint8_t bitOrder;
+  SPISettings(void): bitOrder(MSBFIRST) {}
+  SPISettings(uint32_t /*clock*/, uint8_t order, uint8_t /*dataMode*/): bitOrder(order) {}
+};
+
+// Ansvar: SPI bus med samme grænseflade som Arduinos SPI bibliotek.
+// Uden model af kredse leveres 0xFF, som når MISO trækkes højt.
+class SPIClass {
+public:
+  void begin(void) {}
+  void end(void) {}
+  void beginTransaction(SPISettings settings) {HostSim::spiBitOrder = settings.bitOrder;}
+  void endTransaction(void) {}
+  byte transfer(byte data) {
+    HostSim::noSpiBytes++;
+    return (HostSim::onSpiTransfer != nullptr)? HostSim::onSpiTransfer(data): 0xFF;
+  }
+  void transfer(void *buffer, size_t count) {
+    byte *data = (byte *)buffer;
+    for (size_t cnt=0; cnt < count; cnt++) data[cnt] = transfer(data[cnt]);
+  }
+};
+
+SPIClass SPI;
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af servo på PC
+ * Version: 1.1
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af servo på PC".
+ *
+ * "Simulering af servo på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af servo på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af servo på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter Servo.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * Version 1.1: Advarsler fra compileren er rettet.
+ */
+
+#ifndef Servo_h
+#define Servo_h
+
+#include <Arduino.h>
+
+#define MIN_PULSE_WIDTH 544
+#define MAX_PULSE_WIDTH 2400
+#define DEFAULT_PULSE_WIDTH 1500
+#define REFRESH_INTERVAL 20000
+
+// Ansvar: Virtuel servo. Gemmer pulsbredden i stedet for at styre en pwm-port.
+// pin: Tilkoblet pin. 0 betyder ikke tilkoblet.
+// pulseWidth: Seneste pulsbredde i mikrosek.
+class Servo {
+private:
+  byte pin;
+  int pulseWidth;
+public:
+  Servo(void): pin(0), pulseWidth(DEFAULT_PULSE_WIDTH) {}
+  byte attach(int pin) {this->pin = pin; return pin;}
+  byte attach(int pin, int /*min*/, int /*max*/) {return attach(pin);}
+  void detach(void) {pin = 0;}
+  void write(int angle) {pulseWidth = map(constrain(angle, 0, 180), 0, 180, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH);}
+  void writeMicroseconds(int value) {pulseWidth = value;}
+  int read(void) {return map(pulseWidth, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH, 0, 180);}
+  int readMicroseconds(void) {return pulseWidth;}
+  bool attached(void) {return pin != 0;}
+};
+
+#endif
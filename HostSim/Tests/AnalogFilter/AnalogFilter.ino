@@ -0,0 +1,154 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af analogt filter og sensor med hysterese
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af analogt filter og sensor med hysterese".
+ *
+ * "Test af analogt filter og sensor med hysterese" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af analogt filter og sensor med hysterese" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af analogt filter og sensor med hysterese".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver filteret i t_AnalogParrInDrv og t_HysteresisSensor. Testen sætter selv de analoge indgange i hver cyklus.
+ * Glatning nærmer sig et skridt uden at skyde over, og oversampling af en indgang der skifter mellem to værdier, giver ekstra opløsning.
+ * Sensorer med hysterese skifter ikke, når støjen holder sig mellem niveauerne, og tændes og slukkes i begge retninger.
+ */
+
+#include <HostTest.h>
+
+#include <JBKernel.h>
+const unsigned int MaxNoInParrPorts = 1;
+#include <JBInputDriver.h>
+const unsigned int MaxNoInAnlPorts = 4;
+#include <JBAnalogInDriver.h>
+#include <JBSensor.h>
+
+// Ansvar: Porte, filtre og indgange i testen.
+// RawPort, SmoothPort, OversamplePort, SensorPort: Porte uden filter, med glatning, med oversampling og til sensorer.
+// Smoothing, ExtraBits: Filtrenes indstilling.
+// StepTime, StepValue: Tidspunkt og værdi for skridt på porte uden filter og med glatning.
+// DitherLow: Oversampling får skiftevis DitherLow og DitherLow+1. Output er gennemsnittet med ExtraBits ekstra bit.
+// t_Phase: Sensorernes indgang. Niveau med støj fra tidspunktet og forventet tilstand for sensorerne ved slutningen.
+// Phases: Faser for sensorernes indgang.
+// Noise: Største afvigelse fra niveauet. Mindre end afstanden fra niveauet til sensorernes niveauer.
+enum {RawPort, SmoothPort, OversamplePort, SensorPort};
+const byte Pins[MaxNoInAnlPorts] = {A0, A1, A2, A3};
+const byte Smoothing = 3;
+const byte ExtraBits = 2;
+const unsigned long StepTime = 1000;
+const int StepValue = 800;
+const int DitherLow = 500;
+struct t_Phase {
+  unsigned long time;
+  int level;
+  byte darkState;
+  byte brightState;
+};
+const t_Phase Phases[] = {
+  {0, 650, OFF, OFF},
+  {2000, 550, ON, OFF},
+  {3000, 650, ON, OFF},
+  {4000, 750, OFF, ON},
+  {5000, 650, OFF, ON},
+  {6000, 550, ON, OFF}
+};
+const unsigned int NoPhases = sizeof(Phases)/sizeof(Phases[0]);
+const int Noise = 40;
+
+t_AnalogParrInDrv analogParrInDrv;
+t_HysteresisSensor darkSensor(600, 700);
+t_HysteresisSensor brightSensor(700, 600);
+
+// Ansvar: Målinger.
+// lastSmooth: Værdi af porten med glatning i forrige cyklus.
+// lastOversample: Værdi af porten med oversampling i forrige cyklus.
+// noOversamples: Antal nye værdier fra oversampling.
+// lastDark, lastBright: Sensorernes tilstand i forrige cyklus.
+// noSwitches: Antal skift for hver sensor.
+int lastSmooth = 0;
+int lastOversample = 0;
+unsigned int noOversamples = 0;
+byte lastDark = OFF;
+byte lastBright = OFF;
+unsigned int noSwitches[2];
+
+// Fasen skifter i cyklussen før tidspunktet, så sensorerne ser den nye fase fra tidspunktet.
+unsigned int phaseAt(unsigned long now) {
+  unsigned int phase = 0;
+  while ((phase+1 < NoPhases) && (Phases[phase+1].time <= now)) phase++;
+  return phase;
+}
+
+void setInputs(unsigned long now) {
+  int noise = (int)((Clock::ticks*37) % (2*Noise+1))-Noise;
+  HostSim::setAnalog(Pins[RawPort], (now < StepTime)? 0: StepValue);
+  HostSim::setAnalog(Pins[SmoothPort], (now < StepTime)? 0: StepValue);
+  HostSim::setAnalog(Pins[OversamplePort], DitherLow+(Clock::ticks & 1));
+  HostSim::setAnalog(Pins[SensorPort], Phases[phaseAt(now)].level+noise);
+}
+
+void setup() {
+  setInputs(0);
+  for (byte portNo=0; portNo < MaxNoInAnlPorts; portNo++) analogParrInDrv.setPort(portNo, Pins[portNo]);
+  analogParrInDrv.setFilter(SmoothPort, Smoothing);
+  analogParrInDrv.setFilter(OversamplePort, 0, ExtraBits);
+  analogParrInDrv.read(SmoothPort, &lastSmooth);
+  analogParrInDrv.read(OversamplePort, &lastOversample);
+  darkSensor.begin(&analogParrInDrv, SensorPort);
+  brightSensor.begin(&analogParrInDrv, SensorPort);
+}
+
+void loop() {
+  Clock::pendulum();
+  unsigned long now = millis();
+  setInputs(now);
+  analogParrInDrv.doClockCycle();
+  darkSensor.doClockCycle();
+  brightSensor.doClockCycle();
+  int value = 0;
+
+  analogParrInDrv.read(RawPort, &value);
+  HostTest::check(value == ((now < StepTime)? 0: StepValue), "Port uden filter leverer hver sample uændret");
+
+  analogParrInDrv.read(SmoothPort, &value);
+  if (now == StepTime) HostTest::check((value > 0) && (value < StepValue), "Glatning dæmper et skridt");
+  HostTest::check((value >= lastSmooth) && (value <= StepValue), "Glatning nærmer sig skridtet uden at skyde over");
+  if (now >= StepTime+500) HostTest::check(value == StepValue, "Glatning når skridtet");
+  lastSmooth = value;
+
+  analogParrInDrv.read(OversamplePort, &value);
+  if (value != lastOversample) noOversamples++;
+  if (now >= 1000) HostTest::check(value == ((2*DitherLow+1) << ExtraBits)/2, "Oversampling giver ekstra opløsning");
+  lastOversample = value;
+
+  byte dark = darkSensor.status();
+  byte bright = brightSensor.status();
+  if (dark != lastDark) noSwitches[0]++;
+  if (bright != lastBright) noSwitches[1]++;
+  lastDark = dark;
+  lastBright = bright;
+  unsigned int phase = phaseAt(now);
+  if ((phase+1 < NoPhases) && (now+Clock::ClockCycle == Phases[phase+1].time)) {
+    HostTest::check(dark == Phases[phase].darkState, "Sensor der tændes under niveauet, har forventet tilstand");
+    HostTest::check(bright == Phases[phase].brightState, "Sensor der tændes over niveauet, har forventet tilstand");
+  }
+
+  if (now == 10000) {
+    HostTest::check(noOversamples == 1, "Oversampling med skiftende indgang giver en fast værdi");
+    HostTest::check(noSwitches[0] == 3, "Sensor der tændes under niveauet, skifter kun ved niveauerne");
+    HostTest::check(noSwitches[1] == 2, "Sensor der tændes over niveauet, skifter kun ved niveauerne");
+  }
+}
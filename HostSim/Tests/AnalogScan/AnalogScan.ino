@@ -0,0 +1,98 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af analog input driver med skanning
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af analog input driver med skanning".
+ *
+ * "Test af analog input driver med skanning" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af analog input driver med skanning" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af analog input driver med skanning".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver t_AnalogScanInDrv med to porte på kanaler i en anden rækkefølge end portene.
+ * Hver port leverer sin egen kanal, et skridt i indgangen ses i cyklussen efter og meldes som skift i præcis en cyklus.
+ * En anden samling kan ikke konfigurere porte, når skanningen allerede har en ejer.
+ */
+
+#include <HostTest.h>
+
+#include <JBKernel.h>
+const unsigned int MaxNoInParrPorts = 1;
+#include <JBInputDriver.h>
+const unsigned int MaxNoInAnlPorts = 2;
+#define JB_ADC_SCAN
+#include <JBAnalogInDriver.h>
+
+// Ansvar: Porte og forventede værdier. Værdierne følger scenariet.
+// t_Step: Tidspunkt i msek og værdi for hver port fra tidspunktet.
+// Steps: Skridt i scenariet.
+// NoChanges: Antal skift for hver port efter start.
+enum {PortA, PortB, NoPorts};
+const byte Pins[NoPorts] = {A2, A0};
+struct t_Step {
+  unsigned long time;
+  int values[NoPorts];
+};
+const t_Step Steps[] = {
+  {0, {900, 100}},
+  {1000, {900, 400}},
+  {2000, {50, 400}},
+  {3000, {0, 1023}}
+};
+const unsigned int NoSteps = sizeof(Steps)/sizeof(Steps[0]);
+const unsigned int NoChanges[NoPorts] = {2, 2};
+
+t_AnalogScanInDrv analogScanInDrv;
+t_AnalogScanInDrv otherScanInDrv;
+
+// Ansvar: Målinger af portene.
+// noChanges: Antal cyklusser hvor porten er meldt som skiftet.
+unsigned int noChanges[NoPorts];
+
+// Skridt ses først i cyklussen efter, fordi skanningen kopieres ved starten af cyklus.
+int expected(byte portNo, unsigned long now) {
+  unsigned int step = 0;
+  while ((step+1 < NoSteps) && (Steps[step+1].time+Clock::ClockCycle <= now)) step++;
+  return Steps[step].values[portNo];
+}
+
+void setup() {
+  int value = 0;
+  for (byte portNo=0; portNo < NoPorts; portNo++) {
+    analogScanInDrv.setPort(portNo, Pins[portNo]);
+    HostTest::check((analogScanInDrv.read(portNo, &value) == true) && (value == Steps[0].values[portNo]), "Første værdi læses ved konfigurering");
+  }
+  otherScanInDrv.setPort(0, A3);
+  HostTest::check(otherScanInDrv.read(0, &value) == false, "En anden samling kan ikke konfigurere porte");
+}
+
+void loop() {
+  Clock::pendulum();
+  analogScanInDrv.doClockCycle();
+  otherScanInDrv.doClockCycle();
+  unsigned long now = millis();
+  for (byte portNo=0; portNo < NoPorts; portNo++) {
+    int value = 0;
+    analogScanInDrv.read(portNo, &value);
+    HostTest::check(value == expected(portNo, now), "Porten leverer sin kanals seneste konvertering");
+    if (analogScanInDrv.hasChanged(portNo) == true) noChanges[portNo]++;
+  }
+  if (now == 10000) {
+    for (byte portNo=0; portNo < NoPorts; portNo++) {
+      HostTest::check(noChanges[portNo] == NoChanges[portNo], "Hvert skridt meldes som skift i en cyklus");
+    }
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af BAM driver
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af BAM driver".
+ *
+ * "Test af BAM driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af BAM driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af BAM driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBBamOutDrv ved at måle tid med HIGH på hver pin over et helt antal perioder.
+ * Pin 2-18 har niveau 0, 15, ... 240. Pin 19 tændes med en styreenhed og har niveau 255.
+ * Pin 2 får niveau 128 undervejs og måles igen.
+ */
+
+#include <math.h>
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoOutParrPorts = 1;
+const unsigned int MaxNoOutBamPorts = 18;
+#include <JBBamOutDrv.h>
+#include <JBCtrlUnits.h>
+enum {FirstPin=2, LampePort=17};
+const unsigned long Window = 2040;  // 500 perioder á 4,08 msek
+t_BamOutDrv bam;
+t_OnOffOut lampe;
+
+// Ansvar: Måler tid med HIGH på pins.
+// highSince: Tidspunkt i mikrosek hvor pin gik HIGH
+// highTime: Samlet tid med HIGH i mikrosek
+// startTime: Tidspunkt i mikrosek hvor målingen startede
+// trace(...): Modtager skift på pins
+// start(...): Starter måling
+// duty(...): Leverer andel med HIGH i procent siden start
+namespace Duty {
+  unsigned long highSince[20];
+  unsigned long highTime[20];
+  unsigned long startTime = 0;
+  void trace(byte pin, byte level);
+  void start(void);
+  double duty(byte pin);
+}
+
+void Duty::trace(byte pin, byte level) {
+  if (level == HIGH) highSince[pin] = micros();
+  else highTime[pin] += micros()-highSince[pin];
+}
+
+void Duty::start(void) {
+  startTime = micros();
+  for (byte pin=0; pin < 20; pin++) {
+    highTime[pin] = 0;
+    highSince[pin] = startTime;
+  }
+  HostSim::onPinChange = trace;
+}
+
+double Duty::duty(byte pin) {
+  unsigned long highTime = Duty::highTime[pin];
+  if (HostSim::pinOut(pin) == HIGH) highTime += micros()-highSince[pin];
+  return 100.0*highTime/(micros()-startTime);
+}
+
+byte level(byte portNo) {
+  return (portNo == LampePort)? 255: portNo*15;
+}
+
+void setup() {
+  for (byte portNo=0; portNo < MaxNoOutBamPorts; portNo++) bam.setPort(portNo, FirstPin+portNo, level(portNo));
+  bam.begin();
+  lampe.begin(&bam, LampePort, ON);
+}
+
+void loop() {
+  bool isExact = true;
+  Clock::pendulum();
+  unsigned long time = millis();
+  if ((time == 500) || (time == 3500)) Duty::start();
+  if (time == 500+Window) {
+    HostSim::onPinChange = nullptr;
+    for (byte portNo=0; portNo < MaxNoOutBamPorts; portNo++) {
+      double expected = 100.0*level(portNo)/255;
+      if (fabs(Duty::duty(FirstPin+portNo)-expected) > 0.1) {
+        printf("%10.3f s  pin %2u: %6.2f %%, forventet %6.2f %%\n", time/1000.0, FirstPin+portNo, Duty::duty(FirstPin+portNo), expected);
+        isExact = false;
+      }
+    }
+    HostTest::check(isExact, "Andel med HIGH svarer til niveau på alle pins");
+  }
+  if (time == 3000) bam.write(0, 128);
+  if (time == 3500+Window) {
+    HostSim::onPinChange = nullptr;
+    HostTest::check(fabs(Duty::duty(FirstPin)-100.0*128/255) <= 0.1, "Nyt niveau slår igennem");
+  }
+  bam.doClockCycle();
+}
@@ -0,0 +1,118 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af knapper og skift fra input drivere
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af knapper og skift fra input drivere".
+ *
+ * "Test af knapper og skift fra input drivere" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af knapper og skift fra input drivere" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af knapper og skift fra input drivere".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver t_SimpleButton og t_ButtonBank med en driver der udgiver skift, og en driver der ikke gør.
+ * En driver der ikke udgiver, melder alle porte som skiftet, og en simpel knap på den følger porten.
+ * En simpel knap der kører sjældnere end driveren, følger også porten. En samling af knapper springer cyklusser uden skift over
+ * og giver samme resultat, som hvis den havde regnet.
+ */
+
+#include <HostTest.h>
+
+#include <JBKernel.h>
+const unsigned int MaxNoInParrPorts = 2;
+#include <JBInputDriver.h>
+#include <JBDigitalFunctions.h>
+#include <JBManual.h>
+
+// Ansvar: Porte og pins i testen.
+// PlainPin: Pin for driveren der ikke udgiver skift.
+// SlowPort, TogglePort: Porte i driveren der udgiver skift. SlowPin og TogglePin er tilsvarende pins.
+// SlowPeriod: Den langsomme knap kører hver SlowPeriod cyklus.
+// NoPresses: Antal tryk på TogglePin i scenariet.
+const byte PlainPin = 4;
+enum {SlowPort, TogglePort};
+const byte SlowPin = 5;
+const byte TogglePin = 6;
+const unsigned long SlowPeriod = 3;
+const unsigned int NoPresses = 3;
+
+// Ansvar: Input driver som en applikation kan have skrevet, før drivere udgav skift. Den læser 1 pin og udgiver aldrig.
+// pin: Input pin.
+// value: Værdien læst i denne cyklus.
+class t_PlainInDrv: public t_InputDriver {
+private:
+  byte pin;
+  bool value;
+public:
+  t_PlainInDrv(byte pin): pin(pin), value(LOW) {pinMode(pin, INPUT);}
+  void doClockCycle() {value = digitalRead(pin);}
+  bool read(unsigned int /*portNo*/, int * /*value*/) {return value;}
+};
+
+t_PlainInDrv plainInDrv(PlainPin);
+t_DigitalParrInDrv digitalParrInDrv;
+t_SimpleButton plainButton;
+t_SimpleButton slowButton;
+t_ButtonBank buttonBank;
+
+// Ansvar: Målinger.
+// lastSlow, lastToggle: Driverens værdi af portene i forrige cyklus.
+// noPresses: Antal tryk set på TogglePort.
+// noPlainChanges: Antal skift på knappen med driveren der ikke udgiver.
+bool lastSlow = LOW;
+bool lastToggle = LOW;
+unsigned int noPresses = 0;
+unsigned int noPlainChanges = 0;
+byte lastPlain = OFF;
+
+void setup() {
+  digitalParrInDrv.setPort(SlowPort, SlowPin, NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+  digitalParrInDrv.setPort(TogglePort, TogglePin, NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+  plainButton.begin(&plainInDrv, 0);
+  slowButton.begin(&digitalParrInDrv, SlowPort);
+  buttonBank.begin(&digitalParrInDrv);
+  buttonBank.setButton(1UL << TogglePort, (1 << FCT_EDGEUP) | (1 << FCT_TOGGLE));
+}
+
+void loop() {
+  Clock::pendulum();
+  plainInDrv.doClockCycle();
+  digitalParrInDrv.doClockCycle();
+
+  plainButton.doClockCycle();
+  HostTest::check((plainInDrv.hasChanged(0) == true) && (plainInDrv.changes() == 0xFFFFFFFF), "Driver der ikke udgiver, melder alle porte som skiftet");
+  HostTest::check(plainButton.status() == ((digitalRead(PlainPin) == HIGH)? ON: OFF), "Knap følger driver der ikke udgiver skift");
+  if (plainButton.status() != lastPlain) noPlainChanges++;
+  lastPlain = plainButton.status();
+
+  bool slow = digitalParrInDrv.read(SlowPort);
+  bool toggle = digitalParrInDrv.read(TogglePort);
+  HostTest::check(digitalParrInDrv.hasChanged(SlowPort) == (slow != lastSlow), "Driver melder skift i cyklussen hvor porten skifter");
+  if (Clock::ticks % SlowPeriod == 0) {
+    slowButton.doClockCycle();
+    HostTest::check(slowButton.status() == ((slow == HIGH)? ON: OFF), "Knap der kører sjældnere end driveren, følger porten");
+  }
+  lastSlow = slow;
+
+  buttonBank.doClockCycle();
+  if ((toggle == HIGH) && (lastToggle == LOW)) noPresses++;
+  lastToggle = toggle;
+  HostTest::check(buttonBank.status(TogglePort) == (((noPresses & 1) != 0)? ON: OFF), "Samling af knapper skifter ved hvert tryk");
+
+  if (millis() == 10000) {
+    HostTest::check(noPresses == NoPresses, "Alle tryk er set");
+    HostTest::check(noPlainChanges == 4, "Knap med driver der ikke udgiver, har fulgt alle skift");
+  }
+}
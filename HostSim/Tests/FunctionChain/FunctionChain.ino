@@ -0,0 +1,132 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af oversat kæde af digitale funktioner
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af oversat kæde af digitale funktioner".
+ *
+ * "Test af oversat kæde af digitale funktioner" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af oversat kæde af digitale funktioner" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af oversat kæde af digitale funktioner".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver t_FunctionChain mod kæder af objekter med samme funktioner og startværdier. Indgangen er pseudotilfældig.
+ * En oversat kæde giver samme resultat som objekterne, også efter reset. En kæde med en egen funktion uden opCode eller
+ * med en tidsfunktion kan ikke oversættes og beregnes som objekterne.
+ * En knap oversætter sin kæde i første cyklus, så begin på objekterne efter setDigitalFunction kommer med.
+ */
+
+#include <HostTest.h>
+
+#include <JBKernel.h>
+const unsigned int MaxNoInParrPorts = 1;
+#include <JBInputDriver.h>
+#include <JBDigitalFunctions.h>
+#include <JBManual.h>
+
+// Ansvar: Egen digital funktion, som en applikation kan have skrevet, før kæder blev oversat. Den har ingen opCode.
+// Forsinker indgangen en cyklus.
+class t_Delay : public t_DigitalFunction {
+public:
+  t_Delay(void) {value = OFF;}
+  bool dataOut(bool value) {
+    bool last = this->value;
+    this->value = value;
+    return (digitalFunction != nullptr)? digitalFunction->dataOut(last): last;
+  }
+};
+
+// Ansvar: Funktioner til en kæde af objekter.
+// negator, edge, reg, toggle, delay, onDelay: Funktionerne.
+// build(...): Sætter startværdier og kobler funktionerne i kæden med nummer chainNo. Leverer første funktion.
+struct t_Objects {
+  t_Negator negator;
+  t_EdgeDetector edge;
+  t_Register reg;
+  t_Toggle toggle;
+  t_Delay delay;
+  t_OnDelay onDelay;
+  t_DigitalFunction *build(byte chainNo);
+};
+
+t_DigitalFunction *t_Objects::build(byte chainNo) {
+  edge.begin(OFF, EDGEUP);
+  reg.begin(OFF);
+  toggle.begin(ON);
+  onDelay.begin(20);
+  switch (chainNo) {
+    case 0: negator.setDigitalFunction(&edge); edge.setDigitalFunction(&toggle); return &negator;
+    case 1: edge.begin(ON, EDGEDOWN); edge.setDigitalFunction(&reg); return &edge;
+    case 2: negator.setDigitalFunction(&reg); reg.setDigitalFunction(&toggle); return &negator;
+    case 3: edge.setDigitalFunction(&delay); delay.setDigitalFunction(&toggle); return &edge;
+    default: onDelay.setDigitalFunction(&toggle); return &onDelay;
+  }
+}
+
+// Ansvar: Kæder i testen. Hver kæde findes som oversat kæde og som objekter.
+// NoChains: Antal kæder.
+// IsCompilable: Om kæden kan oversættes.
+// ResetPeriod: Antal cyklusser mellem reset af kæderne.
+// ButtonPin: Pin for knappen. Den påvirkes ikke og er lav.
+const byte NoChains = 5;
+const bool IsCompilable[NoChains] = {true, true, true, false, false};
+const unsigned long ResetPeriod = 97;
+const byte ButtonPin = 7;
+
+t_Objects compiledObjects[NoChains];
+t_Objects objects[NoChains];
+t_DigitalFunction *heads[NoChains];
+t_FunctionChain chains[NoChains];
+t_Toggle buttonToggle;
+t_DigitalParrInDrv digitalParrInDrv;
+t_Button button;
+
+// Ansvar: Pseudotilfældig indgang.
+// seed: Tilstand for generatoren.
+// next(...): Leverer næste bit.
+namespace Input {
+  unsigned long seed = 12345;
+  bool next(void) {seed = seed*1103515245UL+12345; return ((seed >> 16) & 1) != 0;}
+}
+
+void setup() {
+  for (byte chainNo=0; chainNo < NoChains; chainNo++) {
+    bool isCompiled = chains[chainNo].compile(compiledObjects[chainNo].build(chainNo));
+    HostTest::check(isCompiled == IsCompilable[chainNo], "Kæden oversættes, når alle funktioner kan oversættes");
+    heads[chainNo] = objects[chainNo].build(chainNo);
+  }
+  digitalParrInDrv.setPort(0, ButtonPin, NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+  button.begin(&digitalParrInDrv, 0);
+  button.setDigitalFunction(&buttonToggle);
+  buttonToggle.begin(ON);
+}
+
+void loop() {
+  Clock::pendulum();
+  digitalParrInDrv.doClockCycle();
+  button.doClockCycle();
+  if (Clock::ticks == 1) HostTest::check(button.status() == ON, "Knap oversætter med værdier fra begin efter setDigitalFunction");
+
+  for (byte chainNo=0; chainNo < NoChains; chainNo++) {
+    if (Clock::ticks % ResetPeriod == 0) {
+      chains[chainNo].reset();
+      heads[chainNo]->reset();
+    }
+  }
+  bool value = Input::next();
+  for (byte chainNo=0; chainNo < NoChains; chainNo++) {
+    HostTest::check(chains[chainNo].dataOut(value) == heads[chainNo]->dataOut(value), "Kæden giver samme resultat som objekterne");
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af dvale mellem taktslag
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af dvale mellem taktslag".
+ *
+ * "Test af dvale mellem taktslag" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af dvale mellem taktslag" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af dvale mellem taktslag".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver Clock::pendulum med dvale mellem taktslag. Scenariet slår dvale til og ændrer gennemløbstiden.
+ * CPU vækkes kun af timer 0 på hele msek, en gang for hver msek der er ledig i cyklussen, og taktslaget leveres til tiden.
+ * Når gennemløbet er længere end cyklussen, går CPU ikke i dvale, og tabte taktslag tælles.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+// Ansvar: Faser i scenariet med gennemløbstid og dvale. Kontroller sker inde i fasen, så skift ikke tæller med.
+// t_Phase: Start og slut i msek, gennemløbstid i msek og om dvale er slået til
+struct t_Phase {
+  unsigned long start;
+  unsigned long end;
+  byte load;
+  bool isSleep;
+};
+const t_Phase Phases[] = {
+  {0, 10000, 0, true},
+  {10000, 20000, 2, true},
+  {20000, 30000, 7, true},
+  {30000, 40000, 0, false}
+};
+const byte NoPhases = sizeof(Phases)/sizeof(Phases[0]);
+const unsigned long Margin = 100;
+
+unsigned long lastWakeups = 0;
+
+void wake(unsigned long us) {
+  HostTest::check(us % 1000 == 0, "CPU vækkes kun af timer 0 på hele msek");
+}
+
+void setup() {
+  HostSim::onWake = wake;
+}
+
+void loop() {
+  Clock::pendulum();
+  unsigned long time = millis();
+  unsigned long noWakeups = HostSim::noWakeups-lastWakeups;
+  lastWakeups = HostSim::noWakeups;
+  for (byte cnt=0; cnt < NoPhases; cnt++) {
+    const t_Phase &phase = Phases[cnt];
+    if ((time < phase.start+Margin) || (time >= phase.end-Margin)) continue;
+    if (time == phase.start+Margin) Clock::resetStats();
+    bool isInTime = (phase.load <= Clock::ClockCycle);
+    unsigned long expected = ((phase.isSleep == true) && (isInTime == true))? Clock::ClockCycle-phase.load: 0;
+    HostTest::check(noWakeups == expected, "En opvågning for hver ledig msek i cyklussen");
+    if (isInTime == true) HostTest::check(time % Clock::ClockCycle == 0, "Taktslaget leveres til tiden");
+    if (time == phase.end-Margin-Clock::ClockCycle) {
+      HostTest::check(Clock::stats.maxBodyTime == phase.load, "Længste gennemløb er gennemløbstiden");
+      if (isInTime == true) HostTest::check(Clock::stats.missedCycles == 0, "Ingen tabte taktslag");
+      else HostTest::check(Clock::stats.missedCycles > 0, "Tabte taktslag tælles, når gennemløbet er for langt");
+      HostTest::check((Clock::stats.slack[0] > 0) == !isInTime, "Overskredet cyklus tælles kun ved for langt gennemløb");
+    }
+  }
+}
@@ -0,0 +1,95 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af logisk netværk
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af logisk netværk".
+ *
+ * "Test af logisk netværk" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af logisk netværk" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af logisk netværk".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBLogicNetwork med timer, latch og gates. Indgangene følger pin 5 og 6, som scenariet påvirker.
+ * Timeren bliver ON efter 2 sek. og OFF med det samme. En kort puls starter ikke timeren, og en ny puls tæller forfra.
+ * Latch sættes af timeren og nulstilles af reset. Skrivning før begin ignoreres.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoLogicNodes = 8;
+const unsigned int MaxNoLogicLinks = 16;
+const unsigned int MaxNoLogicTimers = 2;
+#include <JBLogicNetwork.h>
+enum {StartPin=5, ResetPin=6};
+t_LogicNetwork net;
+byte startIn, resetIn, timerOut, latchOut, xorOut, andOut;
+
+void setup() {
+  t_LogicNetwork early;
+  byte earlyIn = early.addInput(ON);
+  early.write(earlyIn, OFF);
+  early.begin();
+  HostTest::check(early.status(earlyIn) == ON, "Skrivning før begin ignoreres");
+
+  startIn = net.addInput();
+  resetIn = net.addInput();
+  timerOut = net.addTimer(startIn, 2000);
+  latchOut = net.addLatch(timerOut, resetIn);
+  byte xorInputs[2] = {startIn, resetIn};
+  xorOut = net.addGate(LOGIC_XOR, xorInputs, 2);
+  byte andInputs[2] = {startIn, t_LogicNetwork::negated(resetIn)};
+  andOut = net.addGate(LOGIC_AND, andInputs, 2);
+  net.begin();
+}
+
+void loop() {
+  Clock::pendulum();
+  bool isStart = digitalRead(StartPin);
+  bool isReset = digitalRead(ResetPin);
+  net.write(startIn, isStart);
+  net.write(resetIn, isReset);
+  net.doClockCycle();
+  HostTest::check(net.status(xorOut) == (isStart != isReset), "XOR følger indgangene i samme cyklus");
+  HostTest::check(net.status(andOut) == (isStart && !isReset), "AND med negeret indgang følger indgangene i samme cyklus");
+  switch (millis()) {
+    case 2990:
+      HostTest::check(net.status(timerOut) == OFF, "Timer er OFF før varigheden");
+      HostTest::check(net.status(latchOut) == OFF, "Latch er ikke sat før timeren");
+    break;
+    case 3010:
+      HostTest::check(net.status(timerOut) == ON, "Timer er ON efter varigheden");
+      HostTest::check(net.status(latchOut) == ON, "Latch sættes af timeren");
+    break;
+    case 4005:
+      HostTest::check(net.status(timerOut) == OFF, "Timer bliver OFF med det samme");
+      HostTest::check(net.status(latchOut) == ON, "Latch beholder værdien");
+    break;
+    case 5005:
+      HostTest::check(net.status(latchOut) == OFF, "Latch nulstilles af reset");
+    break;
+    case 8500:
+      HostTest::check(net.status(timerOut) == OFF, "Kort puls starter ikke timeren");
+      HostTest::check(net.status(latchOut) == OFF, "Latch sættes ikke af kort puls");
+    break;
+    case 10990:
+      HostTest::check(net.status(timerOut) == OFF, "Timer tæller forfra ved ny puls");
+    break;
+    case 11010:
+      HostTest::check(net.status(timerOut) == ON, "Timer er ON efter ny varighed");
+    break;
+  }
+}
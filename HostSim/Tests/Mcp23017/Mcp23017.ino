@@ -0,0 +1,163 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af MCP23017 driver
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af MCP23017 driver".
+ *
+ * "Test af MCP23017 driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af MCP23017 driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af MCP23017 driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBMcp23017Drv mod en model af kredsen på I2C bussen.
+ * Kredsen læses kun, når INTA er aktiv, og hver aktivering giver en læsning.
+ * Kun ændrede registre for udgange skrives, og højst en gang per cyklus.
+ * Kontakten på GPB1 følger pin 5, som scenariet påvirker.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoInParrPorts = 1;
+const unsigned int MaxNoOutParrPorts = 1;
+#include <JBMcp23017Drv.h>
+enum {McpAddress=0x21, IntPin=2, KontaktPin=5};
+enum {LampePort1=0, LampePort2=1, KnapPort=9, SignalPort=12};
+t_Mcp23017Drv mcp;
+
+// Ansvar: Model af MCP23017 med INTA koblet til Arduino. Registeradressen tælles op ved hver byte.
+// INTA aktiveres, når en indgang med GPINTEN afviger fra værdien ved seneste læsning, og nulstilles ved læsning.
+// regs: Kredsens registre
+// pointer: Registeradresse for næste byte
+// captured: Indgange ved seneste læsning
+// intActive: INTA er aktiv
+// isRunning: Opsætning er færdig. Herefter kontrolleres trafikken.
+// noInts: Antal aktiveringer af INTA
+// noReads: Antal læsninger af GPIO
+// lastOlatTick: Taktslag for seneste skrivning af udgange
+// pins(...): Leverer niveau på kredsens pins. Udgange følger OLAT.
+// checkInt(...): Aktiverer INTA, hvis en indgang har skiftet.
+// write(...): Modtager skrivning fra Arduino.
+// read(...): Leverer læsning til Arduino.
+namespace Mcp {
+  byte regs[0x16];
+  byte pointer = 0;
+  uint16_t captured = 0;
+  bool intActive = false;
+  bool isRunning = false;
+  unsigned int noInts = 0;
+  unsigned int noReads = 0;
+  unsigned long lastOlatTick = 0xFFFFFFFF;
+  uint16_t pins(void);
+  void checkInt(void);
+  bool write(byte address, const byte data[], byte length);
+  byte read(byte address, byte data[], byte length);
+}
+
+uint16_t Mcp::pins(void) {
+  uint16_t direction = word(regs[MCP_IODIR+1], regs[MCP_IODIR]);
+  uint16_t contacts = (digitalRead(KontaktPin) == HIGH)? 0xFFFF: (uint16_t)~(1 << KnapPort);
+  return (contacts & direction) | (word(regs[MCP_OLAT+1], regs[MCP_OLAT]) & ~direction);
+}
+
+void Mcp::checkInt(void) {
+  uint16_t enabled = word(regs[MCP_GPINTEN+1], regs[MCP_GPINTEN]);
+  if ((intActive == true) || (((pins() ^ captured) & enabled) == 0)) return;
+  intActive = true;
+  if (isRunning == true) noInts++;
+  HostSim::setPin(IntPin, LOW);
+}
+
+bool Mcp::write(byte address, const byte data[], byte length) {
+  if (address != McpAddress) return false;
+  if (length > 0) pointer = data[0];
+  if ((isRunning == true) && ((pointer == MCP_OLAT) || (pointer == MCP_OLAT+1))) {
+    HostTest::check(lastOlatTick != Clock::ticks, "Udgange skrives højst en gang per cyklus");
+    lastOlatTick = Clock::ticks;
+  }
+  for (byte cnt=1; cnt < length; cnt++) {
+    if ((isRunning == true) && ((pointer == MCP_OLAT) || (pointer == MCP_OLAT+1))) {
+      HostTest::check(regs[pointer] != data[cnt], "Kun ændrede registre for udgange skrives");
+    }
+    regs[pointer++] = data[cnt];
+  }
+  return true;
+}
+
+byte Mcp::read(byte address, byte data[], byte length) {
+  if (address != McpAddress) return 0;
+  if (isRunning == true) {
+    HostTest::check(intActive == true, "GPIO læses kun, når INTA er aktiv");
+    noReads++;
+  }
+  for (byte cnt=0; cnt < length; cnt++) {
+    if (pointer == MCP_GPIO) data[cnt] = lowByte(pins());
+    else if (pointer == MCP_GPIO+1) data[cnt] = highByte(pins());
+    else data[cnt] = regs[pointer];
+    pointer++;
+  }
+  captured = pins();
+  if (intActive == true) {
+    intActive = false;
+    HostSim::releasePin(IntPin);
+  }
+  return length;
+}
+
+unsigned long noTransactions = 0;
+
+void setup() {
+  HostSim::onI2cWrite = Mcp::write;
+  HostSim::onI2cRead = Mcp::read;
+  mcp.begin(McpAddress, IntPin);
+  mcp.setInPort(KnapPort, NOPEN, EXTERN_PULLUP, BOUNCE_FILTER);
+  mcp.setOutPort(LampePort1);
+  mcp.setOutPort(LampePort2);
+  mcp.setOutPort(SignalPort);
+  Mcp::isRunning = true;
+}
+
+void loop() {
+  Clock::pendulum();
+  Mcp::checkInt();
+  mcp.doClockCycle();
+  bool isOn = mcp.read(KnapPort);
+  mcp.write(LampePort1, isOn);
+  mcp.write(LampePort2, isOn);
+  mcp.write(SignalPort, millis() >= 3000);
+  switch (millis()) {
+    case 1030:
+      HostTest::check(mcp.read(KnapPort) == LOW, "Kontaktprel slår ikke igennem");
+    break;
+    case 1500:
+      HostTest::check(mcp.read(KnapPort) == HIGH, "Knappen er lukket efter kontaktprel");
+      HostTest::check((Mcp::regs[MCP_OLAT] & 0x03) == 0x03, "Lamper er tændt i OLATA");
+    break;
+    case 2500:
+      HostTest::check(mcp.read(KnapPort) == LOW, "Knappen er åbnet efter kontaktprel");
+      HostTest::check((Mcp::regs[MCP_OLAT] & 0x03) == 0, "Lamper er slukket i OLATA");
+    break;
+    case 3500:
+      HostTest::check(Mcp::regs[MCP_OLAT+1] == 0x10, "Signal er tændt i OLATB");
+      noTransactions = HostSim::noI2cTransactions;
+    break;
+    case 5000:
+      HostTest::check(Mcp::noInts == 4, "INTA aktiveres ved hvert skift af kontakten");
+      HostTest::check(Mcp::noReads == Mcp::noInts, "Hver aktivering af INTA giver en læsning");
+      HostTest::check(HostSim::noI2cTransactions == noTransactions, "Ingen trafik på bussen uden skift");
+    break;
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af multivibrator
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af multivibrator".
+ *
+ * "Test af multivibrator" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af multivibrator" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af multivibrator".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBMultivibrator med tre kanaler og standard blink.
+ * Hver periode har præcis det antal taktslag, som kanalen er konfigureret med, og længden af ON følger pulsbredden.
+ * Faseforskydning flytter kanalens start, og hvert skift sker på det taktslag, som nextEdge forudsiger.
+ */
+
+#include <HostTest.h>
+
+const unsigned int MaxNoBlinkers = 3;
+#include <JBMultivibrator.h>
+#include <JBKernel.h>
+enum {NoChannels=MaxNoBlinkers+1};
+
+// Ansvar: Forventet kurveform for kanalerne. Sidste kanal er standard blink.
+// blinkerNo: Kanalens nummer
+// period, dutyCycle, phaseShift: Konfiguration i msek og procent
+// noCycles, onLength, phase: Forventet periode, længde af ON og faseforskydning i taktslag
+struct t_Expected {
+  unsigned int blinkerNo;
+  unsigned int period;
+  byte dutyCycle;
+  unsigned int phaseShift;
+  unsigned long noCycles;
+  unsigned long onLength;
+  unsigned long phase;
+};
+const t_Expected Expected[NoChannels] = {
+  {0, 1000, 50, 0, 200, 100, 0},
+  {1, 1000, 50, 250, 200, 100, 50},
+  {2, 300, 20, 0, 60, 12, 0},
+  {MASTERBLINKERNO, 1000, 50, 0, 200, 100, 0}
+};
+
+// Ansvar: Målinger for hver kanal.
+// lastValue: Kurveform i seneste cyklus
+// nextEdge: Taktslag hvor næste skift forventes. 0 før første måling.
+// riseTick: Taktslag for seneste skift til ON. 0 før første skift.
+// onCount: Antal taktslag med ON siden seneste skift til ON
+// noPeriods: Antal målte perioder
+bool lastValue[NoChannels];
+unsigned long nextEdge[NoChannels];
+unsigned long riseTick[NoChannels];
+unsigned long onCount[NoChannels];
+unsigned long noPeriods[NoChannels];
+
+void setup() {
+  for (byte cnt=0; cnt < MaxNoBlinkers; cnt++) {
+    Multivibrator::setChannel(Expected[cnt].blinkerNo, Expected[cnt].period, Expected[cnt].dutyCycle, Expected[cnt].phaseShift);
+  }
+}
+
+void loop() {
+  Clock::pendulum();
+  for (byte cnt=0; cnt < NoChannels; cnt++) {
+    const t_Expected &expected = Expected[cnt];
+    bool value = blinkerNotification(expected.blinkerNo);
+    if ((nextEdge[cnt] != 0) && (value != lastValue[cnt])) {
+      HostTest::check(Clock::ticks == nextEdge[cnt], "Skift sker på det forudsagte taktslag");
+      if (value == ON) {
+        HostTest::check((Clock::ticks+expected.phase) % expected.noCycles == 0, "Perioden starter efter faseforskydningen");
+        if (riseTick[cnt] != 0) {
+          HostTest::check(Clock::ticks-riseTick[cnt] == expected.noCycles, "Perioden har præcist antal taktslag");
+          HostTest::check(onCount[cnt] == expected.onLength, "Længde af ON følger pulsbredden");
+          noPeriods[cnt]++;
+        }
+        riseTick[cnt] = Clock::ticks;
+        onCount[cnt] = 0;
+      }
+    }
+    if (value == ON) onCount[cnt]++;
+    lastValue[cnt] = value;
+    nextEdge[cnt] = Clock::ticks+blinkerNextEdge(expected.blinkerNo);
+  }
+  if (millis() == 50000) {
+    for (byte cnt=0; cnt < NoChannels; cnt++) {
+      HostTest::check(noPeriods[cnt] >= 50000/Expected[cnt].period-2, "Alle perioder er målt");
+    }
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af input driver med pin change interrupt
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af input driver med pin change interrupt".
+ *
+ * "Test af input driver med pin change interrupt" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af input driver med pin change interrupt" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af input driver med pin change interrupt".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBPinChangeInDrv med en port uden filter, en port med filter for kontaktprel og en port der får mange skift på en gang.
+ * En puls kortere end en cyklus giver aktiv værdi i præcis en cyklus. Filteret skifter, når ventetiden er gået fra seneste skift.
+ * Køen holder alle skift i en cyklus, og når den har været fuld, får porten alligevel indgangens niveau.
+ */
+
+#include <HostTest.h>
+
+const unsigned int MaxNoInParrPorts = 1;
+const unsigned int MaxNoInPCIntPorts = 3;
+#include <JBKernel.h>
+#include <JBInputDriver.h>
+#include <JBPinChangeInDrv.h>
+
+// Ansvar: Porte og pins i testen. Pins til pulser og kontaktprel påvirkes af scenariet, og testen skifter selv pin til køen.
+// PulsePort, BouncePort, BurstPort: Porte uden filter, med filter og til mange skift.
+// PulsePin, BouncePin, BurstPin: Tilsvarende pins.
+// NoPulses: Antal pulser i scenariet.
+// BounceChanges: Tidspunkter hvor porten med filter forventes at skifte. Regnet fra seneste skift i scenariet plus ventetid.
+// NoBurstShort, NoBurstLong: Antal skift der lægges i køen på en gang. Det korte antal er plads til, det lange ikke.
+// BurstShortTime, BurstResetTime, BurstLongTime: Tidspunkter hvor testen skifter BurstPin.
+enum {PulsePort, BouncePort, BurstPort};
+const byte PulsePin = 9;
+const byte BouncePin = 2;
+const byte BurstPin = 10;
+const unsigned int NoPulses = 3;
+const unsigned long BounceChanges[] = {5007+30, 6012+100};
+const unsigned int NoBounceChanges = sizeof(BounceChanges)/sizeof(BounceChanges[0]);
+const byte NoBurstShort = 11;
+const byte NoBurstLong = 20;
+const unsigned long BurstShortTime = 8000;
+const unsigned long BurstResetTime = 8500;
+const unsigned long BurstLongTime = 9000;
+
+t_PinChangeInDrv pinChangeInDrv;
+
+// Ansvar: Målinger af portene.
+// lastPulse, lastBounce: Værdi i forrige cyklus.
+// highCount: Antal cyklusser med aktiv værdi i den nuværende puls.
+// noPulses: Antal målte pulser.
+// noBounceChanges: Antal skift på porten med filter.
+bool lastPulse = LOW;
+bool lastBounce = LOW;
+unsigned int highCount = 0;
+unsigned int noPulses = 0;
+unsigned int noBounceChanges = 0;
+
+void toggleBurst(byte noChanges) {
+  bool level = LOW;
+  for (byte cnt=0; cnt < noChanges; cnt++) {
+    level = !level;
+    HostSim::setPin(BurstPin, level);
+  }
+}
+
+void setup() {
+  pinChangeInDrv.setPort(PulsePort, PulsePin, NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+  pinChangeInDrv.setPort(BouncePort, BouncePin, NOPEN, EXTERN_PULLUP, BOUNCE_FILTER, 100, 30);
+  pinChangeInDrv.setPort(BurstPort, BurstPin, NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+}
+
+void loop() {
+  Clock::pendulum();
+  pinChangeInDrv.doClockCycle();
+  unsigned long now = millis();
+
+  bool pulse = pinChangeInDrv.read(PulsePort);
+  if (pulse == HIGH) highCount++;
+  else if (lastPulse == HIGH) {
+    HostTest::check(highCount == 1, "Puls kortere end en cyklus er aktiv i præcis en cyklus");
+    noPulses++;
+    highCount = 0;
+  }
+  lastPulse = pulse;
+
+  bool bounce = pinChangeInDrv.read(BouncePort);
+  if (bounce != lastBounce) {
+    bool isExpected = (noBounceChanges < NoBounceChanges) && (now >= BounceChanges[noBounceChanges]) && (now < BounceChanges[noBounceChanges]+Clock::ClockCycle);
+    HostTest::check(isExpected, "Filteret skifter når ventetiden er gået fra seneste skift");
+    noBounceChanges++;
+  }
+  lastBounce = bounce;
+
+  if (now == BurstShortTime) toggleBurst(NoBurstShort);
+  if (now == BurstShortTime+10*Clock::ClockCycle) {
+    HostTest::check(pinChangeInDrv.read(BurstPort) == HIGH, "Porten har niveauet efter alle skift i køen");
+    HostTest::check(pinChangeInDrv.lostEvents() == 0, "Køen har plads til skiftene");
+  }
+  if (now == BurstResetTime) HostSim::setPin(BurstPin, LOW);
+  if (now == BurstLongTime) toggleBurst(NoBurstLong);
+  if (now == BurstLongTime+10*Clock::ClockCycle) {
+    HostTest::check(pinChangeInDrv.lostEvents() > 0, "Skift der ikke er plads til, tælles som tabt");
+    HostTest::check(pinChangeInDrv.read(BurstPort) == LOW, "Porten har indgangens niveau efter tabte skift");
+  }
+
+  if (now == 20000) {
+    HostTest::check(noPulses == NoPulses, "Alle pulser er fanget");
+    HostTest::check(noBounceChanges == NoBounceChanges, "Porten med filter har skiftet som forventet");
+  }
+}
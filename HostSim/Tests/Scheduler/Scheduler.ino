@@ -0,0 +1,113 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af opgavestyring
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af opgavestyring".
+ *
+ * "Test af opgavestyring" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af opgavestyring" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af opgavestyring".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBScheduler med fire opgaver med samme periode, en dyr opgave, en opgave med fast fase og to opgaver der tilføjes undervejs.
+ * Den ene tilføjes mellem Clock::pendulum og afvikling af opgaverne, den anden af en opgave under afviklingen.
+ * Opgaver med automatisk fase fordeles på forskellige taktslag, så den største belastning i et taktslag holdes nede.
+ * Hver opgave afvikles præcis, når klokkens tæller af taktslag giver opgavens fase, og en gang per periode.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoTasks = 8;
+#include <JBScheduler.h>
+enum {NoTasks=MaxNoTasks};
+const unsigned long LateStart = 1000;
+const unsigned long InnerStart = 2000;
+const unsigned long EndTime = 50000;
+
+// Ansvar: Registrerer afvikling af opgaverne.
+// runs: Antal afviklinger for hver opgave
+// firstTick: Taktslag for første afvikling
+// load: Samlet pris for opgaver afviklet i dette taktslag
+// addTick: Taktslag hvor opgaven er tilføjet
+// record(...): Registrerer en afvikling og kontrollerer fasen
+namespace Runs {
+  unsigned long addTick[NoTasks];
+  unsigned long runs[NoTasks];
+  unsigned long firstTick[NoTasks];
+  unsigned int load = 0;
+  void record(byte taskNo);
+}
+
+void Runs::record(byte taskNo) {
+  const Scheduler::t_Task &task = Scheduler::tasks[taskNo];
+  HostTest::check(Clock::ticks % task.period == task.phase, "Opgaven afvikles i sin fase");
+  if (runs[taskNo] == 0) firstTick[taskNo] = Clock::ticks;
+  runs[taskNo]++;
+  load += task.cost;
+}
+
+void innerTask(void) {Runs::record(7);}
+void task0(void) {
+  Runs::record(0);
+  if ((millis() >= InnerStart) && (Scheduler::noTasks == 7)) {
+    Runs::addTick[7] = Clock::ticks;
+    HostTest::check(Scheduler::addTask(innerTask, 35), "Opgave kan tilføjes af en opgave");
+  }
+}
+void task1(void) {Runs::record(1);}
+void task2(void) {Runs::record(2);}
+void task3(void) {Runs::record(3);}
+void heavyTask(void) {Runs::record(4);}
+void fixedTask(void) {Runs::record(5);}
+void lateTask(void) {Runs::record(6);}
+
+void setup() {
+  Scheduler::addTask(task0, 20);
+  Scheduler::addTask(task1, 20);
+  Scheduler::addTask(task2, 20);
+  Scheduler::addTask(task3, 20);
+  Scheduler::addTask(heavyTask, 100, 3);
+  Scheduler::addTask(fixedTask, 40, 1, 15);
+  bool isSpread = true;
+  for (byte cnt=0; cnt < 4; cnt++) {
+    for (byte other=cnt+1; other < 4; other++) isSpread = isSpread && (Scheduler::tasks[cnt].phase != Scheduler::tasks[other].phase);
+  }
+  HostTest::check(isSpread, "Opgaver med samme periode får hver sin fase");
+  HostTest::check(Scheduler::tasks[5].phase == 3, "Fast fase omregnes til taktslag");
+}
+
+void loop() {
+  Clock::pendulum();
+  unsigned long time = millis();
+  if (time == LateStart) {
+    Runs::addTick[6] = Clock::ticks;
+    HostTest::check(Scheduler::addTask(lateTask, 30), "Opgave kan tilføjes undervejs");
+  }
+  Runs::load = 0;
+  Scheduler::doClockCycle();
+  if (time < LateStart) HostTest::check(Runs::load <= 4, "Største belastning i et taktslag er en let og den dyre opgave");
+  if (time != EndTime) return;
+  for (byte cnt=0; cnt < NoTasks; cnt++) {
+    const Scheduler::t_Task &task = Scheduler::tasks[cnt];
+    unsigned long expected = (Clock::ticks-Runs::firstTick[cnt])/task.period+1;
+    HostTest::check((Runs::runs[cnt] > 0) && (Runs::runs[cnt] == expected), "Opgaven afvikles en gang per periode");
+  }
+  for (byte cnt=6; cnt < NoTasks; cnt++) {
+    HostTest::check(Runs::firstTick[cnt]-Runs::addTick[cnt] < Scheduler::tasks[cnt].period, "Ny opgave afvikles første gang inden for sin periode");
+  }
+  HostTest::check(Scheduler::addTask(lateTask, 30) == false, "Ikke flere opgaver end MaxNoTasks");
+}
@@ -0,0 +1,119 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af 74HC165 driver
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af 74HC165 driver".
+ *
+ * "Test af 74HC165 driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af 74HC165 driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af 74HC165 driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBShiftRegIn mod en model af en kæde af 74HC165 på bitniveau.
+ * Kontakter står i et fast mønster, så forkert rækkefølge af bits eller registre opdages.
+ * Tre kontakter følger pin 5, 6 og 7, som scenariet påvirker. To af dem har filter for kontaktprel.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoInParrPorts = 1;
+const unsigned int MaxNoInShiftRegs = 3;
+#include <JBInputDriver.h>
+#include <JBShiftRegIn.h>
+enum {LoadPin=9};
+enum {KnapPort=3, FoelerPort=17, SignalPort=20};
+enum {KnapPin=5, FoelerPin=6, SignalPin=7};
+enum {NoPorts=MaxNoInShiftRegs*8};
+const unsigned long Pattern = 0xA5C381;
+const unsigned long Filtered = (1UL << KnapPort) | (1UL << FoelerPort);
+t_ShiftRegInDrv chain;
+
+// Ansvar: Model af en kæde af 74HC165. Når SH/LD er lav, indlæses kontakterne. Herefter skiftes H, G, ... A ud fra det første register,
+// og næste register skifter ind bagved.
+// parallel: Kontakter ved seneste indlæsning. Bit nr. 8*r+q er Dq på register r.
+// bitNo: Antal bits der er skiftet ud siden indlæsning.
+// contacts(...): Leverer kontakterne. Fast mønster og pins fra scenariet.
+// devicePin(...): Modtager skift på SH/LD.
+// transfer(...): Leverer en byte til Arduino.
+namespace Chain {
+  unsigned long parallel = 0;
+  byte bitNo = 0;
+  unsigned long contacts(void);
+  void devicePin(byte pin, byte level);
+  byte transfer(byte data);
+}
+
+unsigned long Chain::contacts(void) {
+  unsigned long value = Pattern & ~(Filtered | (1UL << SignalPort));
+  if (digitalRead(KnapPin) == HIGH) value |= 1UL << KnapPort;
+  if (digitalRead(FoelerPin) == HIGH) value |= 1UL << FoelerPort;
+  if (digitalRead(SignalPin) == HIGH) value |= 1UL << SignalPort;
+  return value;
+}
+
+void Chain::devicePin(byte pin, byte level) {
+  if ((pin != LoadPin) || (level != LOW)) return;
+  parallel = contacts();
+  bitNo = 0;
+}
+
+byte Chain::transfer(byte /*data*/) {
+  byte result = 0;
+  for (byte cnt=0; cnt < 8; cnt++, bitNo++) {
+    byte value = (bitNo < NoPorts)? (parallel >> ((bitNo & ~7) + 7-(bitNo & 7))) & 1: 0;
+    if (HostSim::spiBitOrder == MSBFIRST) result = (result << 1) | value;
+    else result |= value << cnt;
+  }
+  return result;
+}
+
+void setup() {
+  HostSim::onSpiTransfer = Chain::transfer;
+  HostSim::onDevicePin = Chain::devicePin;
+  chain.begin(LoadPin);
+  for (unsigned int portNo=0; portNo < NoPorts; portNo++) {
+    chain.setPort(portNo, NOPEN, (((Filtered >> portNo) & 1) != 0)? BOUNCE_FILTER: NO_BOUNCE_FILTER);
+  }
+}
+
+void loop() {
+  bool isSame = true;
+  Clock::pendulum();
+  chain.doClockCycle();
+  for (unsigned int portNo=0; portNo < NoPorts; portNo++) {
+    if (((Filtered >> portNo) & 1) == 0) isSame = isSame && (chain.read(portNo) == ((Chain::parallel >> portNo) & 1));
+  }
+  HostTest::check(isSame, "Porte uden filter svarer til kontakterne");
+  switch (millis()) {
+    case 1030:
+      HostTest::check(chain.read(KnapPort) == LOW, "Kontaktprel slår ikke igennem");
+    break;
+    case 1100:
+      HostTest::check(chain.read(KnapPort) == HIGH, "Knappen er lukket efter kontaktprel");
+    break;
+    case 2050:
+      HostTest::check(chain.read(KnapPort) == HIGH, "Knappen åbner først efter ventetid");
+    break;
+    case 2150:
+      HostTest::check(chain.read(KnapPort) == LOW, "Knappen er åbnet efter kontaktprel");
+    break;
+    case 3100:
+      HostTest::check(chain.read(FoelerPort) == HIGH, "Føleren på tredje register er lukket");
+      HostTest::check(chain.read(KnapPort) == LOW, "Føleren påvirker ikke andre porte");
+    break;
+  }
+}
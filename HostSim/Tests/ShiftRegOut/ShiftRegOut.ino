@@ -0,0 +1,119 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af 74HC595 driver
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af 74HC595 driver".
+ *
+ * "Test af 74HC595 driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af 74HC595 driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af 74HC595 driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver JBShiftRegOut mod en model af en kæde af 74HC595 på bitniveau.
+ * Bits skiftes ind i den rækkefølge, som overførslen på SPI er sat op med, så forkert rækkefølge af bits eller registre opdages.
+ * Kæden skrives kun, når en udgang har skiftet.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoOutParrPorts = 1;
+const unsigned int MaxNoOutShiftRegs = 3;
+#include <JBShiftRegOut.h>
+enum {LatchPin=10};
+enum {NoPorts=MaxNoOutShiftRegs*8};
+t_ShiftRegOutDrv chain;
+
+// Ansvar: Model af en kæde af 74HC595. Hver bit skiftes ind i Q0 på det første register, og QH' fører videre til næste register.
+// Udgangene overtager skifteregistrene, når RCLK går høj.
+// shiftReg: Kædens skifteregistre. Bit nr. 8*r+q er Qq på register r.
+// outputs: Kædens udgange efter seneste latch.
+// image: Udgange som testen har skrevet.
+// transfer(...): Modtager en byte fra Arduino.
+// devicePin(...): Modtager skift på RCLK.
+// write(...): Skriver en udgang i driveren og i billedet.
+namespace Chain {
+  unsigned long shiftReg = 0;
+  unsigned long outputs = 0;
+  unsigned long image = 0;
+  byte transfer(byte data);
+  void devicePin(byte pin, byte level);
+  void write(unsigned int portNo, bool value);
+}
+
+byte Chain::transfer(byte data) {
+  for (byte cnt=0; cnt < 8; cnt++) {
+    byte bitNo = (HostSim::spiBitOrder == MSBFIRST)? 7-cnt: cnt;
+    shiftReg = (shiftReg << 1) | ((data >> bitNo) & 1);
+  }
+  return 0;
+}
+
+void Chain::devicePin(byte pin, byte level) {
+  if ((pin == LatchPin) && (level == HIGH)) outputs = shiftReg & ((1UL << NoPorts)-1);
+}
+
+void Chain::write(unsigned int portNo, bool value) {
+  chain.write(portNo, value);
+  if (portNo >= NoPorts) return;
+  image = (value == HIGH)? (image | (1UL << portNo)): (image & ~(1UL << portNo));
+}
+
+void setup() {
+  HostSim::onSpiTransfer = Chain::transfer;
+  HostSim::onDevicePin = Chain::devicePin;
+  chain.begin(LatchPin);
+  HostTest::check(Chain::outputs == 0, "Alle udgange er LOW efter begin");
+}
+
+// Udgange i begge ender af hvert register skrives først. Herefter skifter en udgang i hver cyklus i et sekund.
+void loop() {
+  unsigned long noBytes;
+  Clock::pendulum();
+  unsigned long time = millis();
+  if (time == 100) {
+    Chain::write(0, HIGH);
+    Chain::write(7, HIGH);
+    Chain::write(8, HIGH);
+    Chain::write(23, HIGH);
+  }
+  if (time == 200) {
+    Chain::write(7, LOW);
+    Chain::write(15, HIGH);
+  }
+  if (time == 300) Chain::write(0, HIGH);
+  if (time == 400) Chain::write(NoPorts, HIGH);
+  if ((time >= 1000) && (time < 2000)) {
+    unsigned int portNo = (Clock::ticks*7) % NoPorts;
+    Chain::write(portNo, ((Chain::image >> portNo) & 1) == 0);
+  }
+  noBytes = HostSim::noSpiBytes;
+  chain.doClockCycle();
+  switch (time) {
+    case 100:
+      HostTest::check(Chain::outputs == 0x800181, "Første og sidste udgang på hvert register");
+    break;
+    case 200:
+      HostTest::check(Chain::outputs == 0x808101, "Udgange efter skift på to registre");
+    break;
+    case 300:
+    case 400:
+    case 500:
+      HostTest::check(HostSim::noSpiBytes == noBytes, "Kæden skrives ikke uden skift");
+    break;
+  }
+  if ((time >= 1000) && (time < 2000)) HostTest::check(Chain::outputs == Chain::image, "Udgange svarer til porte");
+}
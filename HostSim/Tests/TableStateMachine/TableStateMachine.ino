@@ -0,0 +1,139 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af tilstandsmaskine med tabeller
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af tilstandsmaskine med tabeller".
+ *
+ * "Test af tilstandsmaskine med tabeller" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af tilstandsmaskine med tabeller" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af tilstandsmaskine med tabeller".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver t_TableStateMachine med tilstande som i DemoApp. Signalerne følger pin 5-8, som scenariet påvirker.
+ * Afgang sker i den cyklus, hvor et signal opfylder betingelsen, og ankomst sker i cyklussen efter, som i mediatoren.
+ * Ankomst og afgang logges og sammenlignes med den forventede rækkefølge.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+#include <JBStateMachine.h>
+enum {Hvile, RumlysOn, LedelysMan, LedelysAut, LedelysOff};
+enum {RUM=1, LYS=2, LEDE=4, TID=8};
+enum {RumPin=5, LysPin=6, LedePin=7, TidPin=8};
+
+// Ansvar: Log over ankomst og afgang.
+// MaxNoEvents: Største antal hændelser i loggen
+// t_Event: Tilstand og om hændelsen er ankomst eller afgang
+// events: Hændelser i rækkefølge
+// signalTime: Tidspunkt hvor signalerne senest skiftede
+// exitTime: Tidspunkt for seneste afgang
+// add(...): Tilføjer en hændelse og kontrollerer, at den sker i den rigtige cyklus
+namespace Log {
+  const byte MaxNoEvents = 16;
+  struct t_Event {
+    byte stateNo;
+    bool isEntry;
+  };
+  t_Event events[MaxNoEvents];
+  byte noEvents = 0;
+  unsigned long signalTime = 0;
+  unsigned long exitTime = 0;
+  void add(byte stateNo, bool isEntry);
+}
+
+void Log::add(byte stateNo, bool isEntry) {
+  if (noEvents == MaxNoEvents) return;
+  if (isEntry == false) {
+    HostTest::check(millis() == signalTime, "Afgang i den cyklus, hvor signalet skifter");
+    exitTime = millis();
+  }
+  else if (noEvents > 0) HostTest::check(millis() == exitTime+Clock::ClockCycle, "Ankomst i cyklussen efter afgang");
+  events[noEvents].stateNo = stateNo;
+  events[noEvents].isEntry = isEntry;
+  noEvents++;
+}
+
+void enterHvile(void) {Log::add(Hvile, true);}
+void exitHvile(void) {Log::add(Hvile, false);}
+void enterRumlysOn(void) {Log::add(RumlysOn, true);}
+void exitRumlysOn(void) {Log::add(RumlysOn, false);}
+void enterLedelysMan(void) {Log::add(LedelysMan, true);}
+void exitLedelysMan(void) {Log::add(LedelysMan, false);}
+void enterLedelysAut(void) {Log::add(LedelysAut, true);}
+void exitLedelysAut(void) {Log::add(LedelysAut, false);}
+void enterLedelysOff(void) {Log::add(LedelysOff, true);}
+void exitLedelysOff(void) {Log::add(LedelysOff, false);}
+
+constexpr t_Transition transitions[] PROGMEM = {
+  {Hvile, RumlysOn, RUM, RUM}, {Hvile, LedelysAut, LYS, LYS}, {Hvile, LedelysMan, LEDE, LEDE},
+  {RumlysOn, Hvile, RUM, RUM},
+  {LedelysMan, RumlysOn, RUM, RUM}, {LedelysMan, Hvile, LEDE, LEDE},
+  {LedelysAut, RumlysOn, RUM, RUM}, {LedelysAut, LedelysOff, LYS, 0},
+  {LedelysOff, RumlysOn, RUM, RUM}, {LedelysOff, Hvile, TID, TID}
+};
+constexpr t_StateActions actions[] PROGMEM = {
+  {enterHvile, exitHvile}, {enterRumlysOn, exitRumlysOn}, {enterLedelysMan, exitLedelysMan},
+  {enterLedelysAut, exitLedelysAut}, {enterLedelysOff, exitLedelysOff}
+};
+t_TableStateMachine stateMachine;
+
+// Forventet forløb efter scenariet
+const Log::t_Event Expected[] = {
+  {Hvile, true},
+  {Hvile, false}, {LedelysAut, true},
+  {LedelysAut, false}, {LedelysOff, true},
+  {LedelysOff, false}, {Hvile, true},
+  {Hvile, false}, {RumlysOn, true},
+  {RumlysOn, false}, {Hvile, true},
+  {Hvile, false}, {LedelysMan, true},
+  {LedelysMan, false}, {Hvile, true}
+};
+const byte NoExpected = sizeof(Expected)/sizeof(Expected[0]);
+
+// Knapper giver en puls på en cyklus, som fra en flankedetektor
+unsigned long readSignals(void) {
+  static bool wasRum = LOW, wasLede = LOW;
+  static unsigned long lastSignals = 0;
+  bool isRum = digitalRead(RumPin), isLede = digitalRead(LedePin);
+  unsigned long signals = 0;
+  if ((isRum == HIGH) && (wasRum == LOW)) signals |= RUM;
+  if ((isLede == HIGH) && (wasLede == LOW)) signals |= LEDE;
+  if (digitalRead(LysPin) == HIGH) signals |= LYS;
+  if (digitalRead(TidPin) == HIGH) signals |= TID;
+  wasRum = isRum;
+  wasLede = isLede;
+  if (signals != lastSignals) Log::signalTime = millis();
+  lastSignals = signals;
+  return signals;
+}
+
+void setup() {
+  stateMachine.begin(transitions, sizeof(transitions)/sizeof(transitions[0]), actions, Hvile);
+}
+
+void loop() {
+  Clock::pendulum();
+  stateMachine.doClockCycle(readSignals());
+  if (millis() != 10000) return;
+  HostTest::check(Log::noEvents == NoExpected, "Antal ankomster og afgange");
+  for (byte cnt=0; (cnt < NoExpected) && (cnt < Log::noEvents); cnt++) {
+    const Log::t_Event &event = Log::events[cnt];
+    bool isSame = (event.stateNo == Expected[cnt].stateNo) && (event.isEntry == Expected[cnt].isEntry);
+    if (isSame == false) printf("%10.3f s  hændelse %u: tilstand %u %s\n", millis()/1000.0, cnt, event.stateNo, (event.isEntry == true)? "ankomst": "afgang");
+    HostTest::check(isSame, "Ankomst og afgang i forventet rækkefølge");
+  }
+  HostTest::check(stateMachine.status() == Hvile, "Slutter i hvile");
+}
@@ -0,0 +1,123 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af digitale funktioner med tid
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af digitale funktioner med tid".
+ *
+ * "Test af digitale funktioner med tid" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af digitale funktioner med tid" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af digitale funktioner med tid".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver t_OnDelay, t_OffDelay, t_Pulse og t_MinOnTime mod en model i taktslag. Indgangen er pseudotilfældig
+ * med perioder både kortere og længere end varigheden. En puls med varighed i sekunder varer hele varigheden.
+ * Tidsfunktioner kan ikke kopieres, fordi deres timer sidder i tidshjulet.
+ */
+
+#include <HostTest.h>
+#include <type_traits>
+
+#include <JBKernel.h>
+#include <JBDigitalFunctions.h>
+
+static_assert(std::is_copy_constructible<t_OnDelay>::value == false, "Tidsfunktioner kan ikke kopieres");
+static_assert(std::is_copy_assignable<t_Pulse>::value == false, "Tidsfunktioner kan ikke tildeles");
+
+// Ansvar: Varigheder i testen.
+// Duration: Varighed i msek for funktionerne, der sammenlignes med modellen.
+// NoCycles: Varigheden i taktslag.
+// LongDuration: Varighed i sekunder for den lange puls.
+// LongStart: Tidspunkt i msek hvor den lange puls startes.
+const unsigned int Duration = 50;
+const unsigned long NoCycles = Duration/Clock::ClockCycle;
+const unsigned int LongDuration = 2;
+const unsigned long LongStart = 1000;
+
+t_OnDelay onDelay;
+t_OffDelay offDelay;
+t_Pulse pulse;
+t_MinOnTime minOnTime;
+t_Pulse longPulse;
+
+// Ansvar: Model af funktionerne i taktslag.
+// lastInput: Indgang i forrige taktslag.
+// edgeTick: Taktslag for seneste skift på indgangen.
+// pulseTick, minOnTick: Taktslag hvor puls og mindste tid senest startede.
+// hasBeenOn: Indgangen har været ON.
+// isPulseStarted, isMinOnStarted: Puls og mindste tid er startet mindst en gang.
+namespace Model {
+  bool lastInput = OFF;
+  unsigned long edgeTick = 0;
+  unsigned long pulseTick = 0;
+  unsigned long minOnTick = 0;
+  bool hasBeenOn = false;
+  bool isPulseStarted = false;
+  bool isMinOnStarted = false;
+}
+
+// Ansvar: Pseudotilfældig indgang, der skifter med sandsynlighed 1/8 i hvert taktslag.
+// seed: Tilstand for generatoren.
+// value: Nuværende indgang.
+// next(...): Leverer næste indgang.
+namespace Input {
+  unsigned long seed = 4711;
+  bool value = OFF;
+  bool next(void) {
+    seed = seed*1103515245UL+12345;
+    if (((seed >> 16) & 7) == 0) value = !value;
+    return value;
+  }
+}
+
+void setup() {
+  onDelay.begin(Duration);
+  offDelay.begin(Duration);
+  pulse.begin(Duration);
+  minOnTime.begin(Duration);
+  longPulse.begin(LongDuration, SECONDS);
+}
+
+void loop() {
+  Clock::pendulum();
+  unsigned long ticks = Clock::ticks;
+  bool value = Input::next();
+  if (value != Model::lastInput) Model::edgeTick = ticks;
+  bool isRising = (value == ON) && (Model::lastInput == OFF);
+  if (value == ON) Model::hasBeenOn = true;
+  if (isRising && ((Model::isPulseStarted == false) || (ticks-Model::pulseTick >= NoCycles))) {
+    Model::pulseTick = ticks;
+    Model::isPulseStarted = true;
+  }
+  if (isRising && ((Model::isMinOnStarted == false) || (ticks-Model::minOnTick >= NoCycles))) {
+    Model::minOnTick = ticks;
+    Model::isMinOnStarted = true;
+  }
+  Model::lastInput = value;
+
+  bool expectOnDelay = (value == ON) && (ticks-Model::edgeTick >= NoCycles);
+  bool expectOffDelay = (value == ON) || (Model::hasBeenOn && (ticks-Model::edgeTick < NoCycles));
+  bool expectPulse = Model::isPulseStarted && (ticks-Model::pulseTick < NoCycles);
+  bool expectMinOn = (value == ON) || (Model::isMinOnStarted && (ticks-Model::minOnTick < NoCycles));
+  HostTest::check(onDelay.dataOut(value) == expectOnDelay, "Tilkoblingsforsinkelse følger modellen");
+  HostTest::check(offDelay.dataOut(value) == expectOffDelay, "Frakoblingsforsinkelse følger modellen");
+  HostTest::check(pulse.dataOut(value) == expectPulse, "Puls følger modellen");
+  HostTest::check(minOnTime.dataOut(value) == expectMinOn, "Mindste tid for ON følger modellen");
+
+  unsigned long now = millis();
+  bool longValue = longPulse.dataOut(now == LongStart);
+  if (now == LongStart+SecondsToMilliSecs((unsigned long)LongDuration)-Clock::ClockCycle) HostTest::check(longValue == ON, "Puls i sekunder varer hele varigheden");
+  if (now == LongStart+SecondsToMilliSecs((unsigned long)LongDuration)) HostTest::check(longValue == OFF, "Puls i sekunder slutter efter varigheden");
+}
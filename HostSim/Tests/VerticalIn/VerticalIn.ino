@@ -0,0 +1,77 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Test af digitale indgange med lodrette tællere
+ * Version: 1.0
+ * Type: Program
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Test af digitale indgange med lodrette tællere".
+ *
+ * "Test af digitale indgange med lodrette tællere" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Test af digitale indgange med lodrette tællere" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Test af digitale indgange med lodrette tællere".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Afprøver t_VerticalInDrv med 8 og 32 indgange mod t_DigitalParrInDrv, der filtrerer hver port for sig.
+ * Pin 2-4 påvirkes af scenariet med prel, korte pulser og indgang uden filter. Alle tre drivere skal levere det samme i hver cyklus.
+ * Ved prel midt i ventetiden starter lodrette tællere forfra, mens parallelle porte tager værdien, når ventetiden udløber.
+ * Her sammenlignes kun de lodrette tællere indbyrdes, og tidspunktet for skift kontrolleres for sig.
+ */
+
+#include <HostTest.h>
+#include <JBKernel.h>
+
+const unsigned int MaxNoInParrPorts = 3;
+#include <JBInputDriver.h>
+enum {NoPorts=MaxNoInParrPorts};
+const byte Pins[NoPorts] = {2, 3, 4};
+const byte Ports32[NoPorts] = {17, 30, 5};
+enum {RestartPort=1};
+const unsigned long RestartStart = 6000, RestartEnd = 6100;
+t_DigitalParrInDrv reference;
+t_VerticalInDrv<byte> vertical8;
+t_VerticalInDrv<unsigned long> vertical32;
+bool lastValue[NoPorts];
+unsigned int noChanges = 0;
+
+void setup() {
+  reference.setPort(0, Pins[0], NOPEN, EXTERN_PULLUP, BOUNCE_FILTER);
+  reference.setPort(1, Pins[1], NCLOSED, INTERN_PULLUP, BOUNCE_FILTER, 50, 20);
+  reference.setPort(2, Pins[2], NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+  vertical8.setPort(0, Pins[0], NOPEN, EXTERN_PULLUP, BOUNCE_FILTER);
+  vertical8.setPort(1, Pins[1], NCLOSED, INTERN_PULLUP, BOUNCE_FILTER, 50, 20);
+  vertical8.setPort(2, Pins[2], NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+  vertical32.setPort(Ports32[0], Pins[0], NOPEN, EXTERN_PULLUP, BOUNCE_FILTER);
+  vertical32.setPort(Ports32[1], Pins[1], NCLOSED, INTERN_PULLUP, BOUNCE_FILTER, 50, 20);
+  vertical32.setPort(Ports32[2], Pins[2], NOPEN, EXTERN_PULLUP, NO_BOUNCE_FILTER);
+}
+
+void loop() {
+  bool isSame = true;
+  Clock::pendulum();
+  reference.doClockCycle();
+  vertical8.doClockCycle();
+  vertical32.doClockCycle();
+  unsigned long time = millis();
+  bool isRestart = (time >= RestartStart) && (time < RestartEnd);
+  for (byte portNo=0; portNo < NoPorts; portNo++) {
+    bool value = ((portNo == RestartPort) && (isRestart == true))? vertical8.read(portNo): reference.read(portNo);
+    isSame = isSame && (vertical8.read(portNo) == value) && (vertical32.read(Ports32[portNo]) == value);
+    if (value != lastValue[portNo]) noChanges++;
+    lastValue[portNo] = value;
+  }
+  HostTest::check(isSame, "Lodrette tællere filtrerer som parallelle porte");
+  if (time == 6035) HostTest::check(vertical8.read(RestartPort) == HIGH, "Prel midt i ventetiden starter ventetiden forfra");
+  if (time == 6060) HostTest::check(vertical8.read(RestartPort) == LOW, "Skift når indgangen har været stabil i hele ventetiden");
+  if (time == 10000) HostTest::check(noChanges == 11, "Indgange skifter efter scenariet");
+}
@@ -0,0 +1,99 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af I2C på PC
+ * Version: 1.1
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af I2C på PC".
+ *
+ * "Simulering af I2C på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af I2C på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af I2C på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter Wire.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * Kredse på bussen modelleres af applikationen eller testen med onI2cWrite og onI2cRead.
+ * En kreds der trækker en interrupt linje, påtrykker pinnen med HostSim::setPin.
+ * Version 1.1: Advarsler fra compileren er rettet.
+ */
+
+#ifndef HostSim_Wire_h
+#define HostSim_Wire_h
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32
+
+// Ansvar: Virtuel I2C bus.
+// onI2cWrite: Model af kredse på bussen. Modtager en skrivning til en adresse. Leverer true, hvis adressen svarer.
+// onI2cRead: Model af kredse på bussen. Fylder bytes fra en adresse i data. Leverer antal bytes, 0 hvis adressen ikke svarer.
+// noI2cTransactions: Antal transaktioner på bussen. Bruges til at måle trafik på bussen.
+// noI2cBytes: Antal overførte bytes uden adresser.
+namespace HostSim {
+  bool (*onI2cWrite)(byte address, const byte data[], byte length)=nullptr;
+  byte (*onI2cRead)(byte address, byte data[], byte length)=nullptr;
+  unsigned long noI2cTransactions=0;
+  unsigned long noI2cBytes=0;
+}
+
+// Ansvar: I2C bus med samme grænseflade som Arduinos Wire bibliotek. Kun rollen som master er med.
+// Skrivninger samles i en buffer og sendes i en transaktion ved endTransmission, som på Arduino.
+// Uden model af kredse svarer ingen adresser.
+// address: Adresse for den igangværende skrivning.
+// buffer, length, index: Data til skrivning eller læste data, der endnu ikke er hentet.
+class TwoWire {
+private:
+  byte address;
+  byte buffer[BUFFER_LENGTH];
+  byte length;
+  byte index;
+public:
+  TwoWire(void): address(0), length(0), index(0) {}
+  void begin(void) {}
+  void end(void) {}
+  void setClock(uint32_t /*clock*/) {}
+  void beginTransmission(uint8_t address) {this->address = address; length = 0;}
+  size_t write(uint8_t data) {
+    if (length >= BUFFER_LENGTH) return 0;
+    buffer[length++] = data;
+    return 1;
+  }
+  size_t write(const uint8_t *data, size_t count) {
+    size_t cnt = 0;
+    while ((cnt < count) && (write(data[cnt]) == 1)) cnt++;
+    return cnt;
+  }
+  // Leverer 0 ved succes og 2, når adressen ikke svarer.
+  uint8_t endTransmission(bool /*sendStop*/=true) {
+    HostSim::noI2cTransactions++;
+    HostSim::noI2cBytes += length;
+    bool isAck = (HostSim::onI2cWrite != nullptr) && HostSim::onI2cWrite(address, buffer, length);
+    length = 0;
+    return (isAck == true)? 0: 2;
+  }
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool /*sendStop*/=true) {
+    if (quantity > BUFFER_LENGTH) quantity = BUFFER_LENGTH;
+    HostSim::noI2cTransactions++;
+    length = (HostSim::onI2cRead != nullptr)? HostSim::onI2cRead(address, buffer, quantity): 0;
+    HostSim::noI2cBytes += length;
+    index = 0;
+    return length;
+  }
+  int available(void) {return length - index;}
+  int read(void) {return (index < length)? buffer[index++]: -1;}
+};
+
+TwoWire Wire;
+
+#endif
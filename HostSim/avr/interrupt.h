@@ -0,0 +1,53 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af interrupt på PC
+ * Version: 1.3
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af interrupt på PC".
+ *
+ * "Simulering af interrupt på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af interrupt på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af interrupt på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter avr/interrupt.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * Version 1.1: Interrupt rutiner og vektorer for pin change interrupt.
+ * Version 1.2: Vektor for A/D konverter.
+ * Version 1.3: Vektor for timer 2.
+ */
+
+#ifndef HostSim_interrupt_h
+#define HostSim_interrupt_h
+
+// Simuleringen afvikles i en tråd. Interrupt rutiner kaldes af simuleringen og afbryder aldrig programmet.
+#define cli()
+#define sei()
+#define interrupts()
+#define noInterrupts()
+
+// Interrupt rutiner er almindelige funktioner, som simuleringen kalder. Vektorer uden rutine er svage symboler med værdien 0.
+#define ISR(vector, ...) extern "C" void vector(void)
+#define PCINT0_vect HostSim_PCINT0_vect
+#define PCINT1_vect HostSim_PCINT1_vect
+#define PCINT2_vect HostSim_PCINT2_vect
+#define ADC_vect HostSim_ADC_vect
+#define TIMER2_COMPA_vect HostSim_TIMER2_COMPA_vect
+extern "C" void PCINT0_vect(void) __attribute__((weak));
+extern "C" void PCINT1_vect(void) __attribute__((weak));
+extern "C" void PCINT2_vect(void) __attribute__((weak));
+extern "C" void ADC_vect(void) __attribute__((weak));
+extern "C" void TIMER2_COMPA_vect(void) __attribute__((weak));
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af program memory på PC
+ * Version: 1.0
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af program memory på PC".
+ *
+ * "Simulering af program memory på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af program memory på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af program memory på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter avr/pgmspace.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * På en PC er der ikke et separat program memory. Data med PROGMEM ligger i RAM og læses direkte.
+ */
+
+#ifndef HostSim_pgmspace_h
+#define HostSim_pgmspace_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(STR) (STR)
+
+#define pgm_read_byte(ADDR) (*(const uint8_t *)(ADDR))
+#define pgm_read_word(ADDR) (*(const uint16_t *)(ADDR))
+#define pgm_read_dword(ADDR) (*(const uint32_t *)(ADDR))
+#define pgm_read_ptr(ADDR) (*(void * const *)(ADDR))
+#define memcpy_P(DEST, SRC, LENGTH) memcpy((DEST), (SRC), (LENGTH))
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Simulering af dvale på PC
+ * Version: 1.1
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Simulering af dvale på PC".
+ *
+ * "Simulering af dvale på PC" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Simulering af dvale på PC" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Simulering af dvale på PC".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Erstatter avr/sleep.h, når biblioteker og applikationer bygges på en PC uden tilsluttet Arduino.
+ * Version 1.1: Påvirkninger fra scenariet sker også under dvale.
+ */
+
+#ifndef HostSim_sleep_h
+#define HostSim_sleep_h
+
+#include <Arduino.h>
+
+#define SLEEP_MODE_IDLE 0
+
+// Ansvar: Simulerer dvale. CPU vækkes af timer 0, som tæller millis op hvert msek.
+// noWakeups: Antal opvågninger fra dvale
+// onWake: Kaldes ved hver opvågning med tiden i mikrosek. Bruges til at kontrollere tidsplan for opvågning.
+// sleepCpu(...): Lader tiden gå frem til næste interrupt fra timer 0.
+namespace HostSim {
+  bool isSleepEnabled=false;
+  unsigned long noWakeups=0;
+  void (*onWake)(unsigned long us)=nullptr;
+  void sleepCpu(void);
+}
+
+#define set_sleep_mode(MODE)
+#define sleep_enable() (HostSim::isSleepEnabled = true)
+#define sleep_disable() (HostSim::isSleepEnabled = false)
+#define sleep_cpu() HostSim::sleepCpu()
+
+/*
+ * CPP kode herunder
+ */
+
+void HostSim::sleepCpu(void) {
+  if (isSleepEnabled == false) return;
+  elapse((microsNow/1000+1)*1000);
+  noWakeups++;
+  if (onWake != nullptr) onWake(microsNow);
+}
+
+#endif
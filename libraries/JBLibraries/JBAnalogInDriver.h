@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Analoge input driver
- * Version: 1.0
+ * Version: 1.7
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 21-02-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of Input drivere.
  * 
@@ -23,6 +23,15 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * t_AnalogScanInDrv og interrupt rutinen ADC_vect findes kun, når applikationen definerer JB_ADC_SCAN før biblioteket inkluderes.
+ * Ellers kan andre biblioteker bruge A/D konverterens interrupt. Når t_AnalogScanInDrv er i brug, må analogRead ikke kaldes andre steder.
+ * Version 1.1: Samling af analoge porte der skannes med A/D konverterens interrupt, så programmet ikke venter på konverteringer.
+ * Version 1.2: Filter med oversampling, decimering og IIR glatning i heltal for begge samlinger af analoge porte.
+ * Version 1.3: Udgiver hvilke porte der har skiftet værdi siden forrige cyklus.
+ * Version 1.4: Konfigurerede porte holdes med 1 bit per port.
+ * Version 1.5: Advarsler fra compileren er rettet.
+ * Version 1.6: Skanning med interrupt vælges med JB_ADC_SCAN, og kun en samling kan eje skanningen.
+ * Version 1.7: Skift udgives med publishChanges, så komponenter kan springe porte uden skift over.
  */
 
 #ifndef JBAnalogInDriver_h
@@ -31,20 +40,56 @@
 #include <Arduino.h>
 #include <JBKernel.h>
 
+// Ansvar: Filtrerer en analog indgang med heltal, så prisen per sample er få instruktioner.
+// Oversampling og decimering giver ekstra opløsning: 4^extraBits samples lægges sammen og deles med 2^extraBits.
+// Derefter glatter et IIR filter af første orden: output += (input - output) / 2^smoothing.
+// Uden ekstra opløsning og glatning leveres hver sample uændret.
+// MaxExtraBits, MaxSmoothing: Største værdier. Summen kan være i et word og tilstanden i et unsigned long.
+// extraBits: Ekstra bit opløsning. Output har 10+extraBits bit.
+// smoothing: IIR filterets koefficient som 2-potens.
+// noSamples: Antal samples i summen.
+// sum: Sum til decimering.
+// state: IIR filterets tilstand. Output med smoothing ekstra bit (fixed point).
+// setFilter(...): Sætter filteret. Filteret startes forfra fra sit nuværende output.
+// reset(...): Starter filteret forfra fra en sample.
+// sample(...): Modtager en sample. Returnerer true, når der er et nyt output.
+// dataOut(...): Leverer filterets output.
+class t_AnalogFilter {
+private:
+  enum {MaxExtraBits=3, MaxSmoothing=8};
+  byte extraBits;
+  byte smoothing;
+  byte noSamples;
+  word sum;
+  unsigned long state;
+public:
+  t_AnalogFilter(void): extraBits(0), smoothing(0), noSamples(0), sum(0), state(0) {}
+  void setFilter(byte smoothing, byte extraBits);
+  void reset(int raw);
+  bool sample(int raw);
+  int dataOut(void) const {return state >> smoothing;}
+};
+
+//----------
+
 // Ansvar Varetager 1 analog parallel input port
 // pin: Input pin.
 // value: Gemmer den indlæste værdi til senere brug.
+// filter: Filter for indgangen. Får en sample per cyklus.
 // setPort(...): Opkobler Arduino og konfigurerer indgangen.
+// setFilter(...): Sætter filter for indgangen.
 // doClockCycle(...): Læser input.
 // read(...): Leverer driverens nuværende værdi.
 class t_AnalogParrInPort {
 private:
   byte pin;
   int value;
+  t_AnalogFilter filter;
 public:
   t_AnalogParrInPort(void) {}
   void setPort(byte pin);
-  void doClockCycle(void) {value = analogRead(pin);}
+  void setFilter(byte smoothing, byte extraBits);
+  void doClockCycle(void) {if (filter.sample(analogRead(pin)) == true) value = filter.dataOut();}
   bool read(int *value);
 };
 
@@ -52,30 +97,118 @@ public:
 
 // Ansvar: Holder styr på en samling af analoge input porte.
 // ports: Vektor med analoge input porte.
-// isSetup: Vektor der holder styr på om port er konfigureret.
+// isSetup: Holder styr på hvilke porte der er konfigureret. Gennemløb koster efter antal porte i brug.
 // setPort(...): Mapper portNo, opkobler Arduino og konfigurerer indgangen.
+// setFilter(...): Sætter filter for en konfigureret port.
 // doClockCycle(...): Læser input.
 // read(...): Leverer driverens nuværende værdi.
 class t_AnalogParrInDrv: public t_InputDriver {
 private:
   t_AnalogParrInPort ports[MaxNoInAnlPorts];
-  bool isSetup[MaxNoInAnlPorts];
+  t_PortSet<MaxNoInAnlPorts> isSetup;
 public:
-  t_AnalogParrInDrv(void) {for (int cnt=0; cnt < MaxNoInAnlPorts; cnt++) isSetup[cnt] = false;}
+  t_AnalogParrInDrv(void) {}
   void setPort(unsigned int portNo, byte pin);
+  void setFilter(unsigned int portNo, byte smoothing, byte extraBits=0);
   void doClockCycle();
   bool read(unsigned int portNo, int *value);
 };
 
+//----------
+
+#if (defined(__AVR__) || defined(ARDUINO_HOSTSIM)) && defined(JB_ADC_SCAN)
+class t_AnalogScanInDrv;
+
+// Ansvar: Skanner analoge indgange på skift med A/D konverterens interrupt.
+// Interrupt rutinen gemmer resultatet, vælger næste kanal og starter næste konvertering. Programmet venter aldrig på konverteringer.
+// scanPorts: Porte i den rækkefølge de skannes.
+// channels: A/D kanal for hver port.
+// filters: Filter for hver port. Får hver konvertering, så oversampling sker med A/D konverterens hastighed.
+// results: Seneste output fra filteret for hver port. Skrives af interrupt rutinen.
+// noChannels: Antal porte i skanningen.
+// current: Indeks i scanPorts for konverteringen der er i gang.
+// owner: Den samling der bruger skanningen. Der er kun en A/D konverter, så kun en samling kan bruge den.
+// select(...): Vælger kanal og starter konvertering.
+// start(...): Starter skanningen forfra.
+// stop(...): Stopper skanningen og venter til en konvertering der er i gang, er færdig.
+namespace AdcScan {
+  static byte scanPorts[MaxNoInAnlPorts];
+  static byte channels[MaxNoInAnlPorts];
+  static t_AnalogFilter filters[MaxNoInAnlPorts];
+  static volatile int results[MaxNoInAnlPorts];
+  static byte noChannels=0;
+  static volatile byte current=0;
+  static t_AnalogScanInDrv *owner=nullptr;
+  void select(byte channel);
+  void start(void);
+  void stop(void);
+}
+
+// Ansvar: Holder styr på en samling af analoge input porte, der skannes med interrupt.
+// Skanningen er fælles for programmet, så der må kun være en samling. Den første samling der konfigurerer en port, ejer skanningen,
+// og andre samlinger kan ikke konfigurere porte.
+// read(...) leverer seneste færdige konvertering, som den var ved starten af cyklus.
+// Referencen er AVcc, som er standard for analogRead. Skanningen bruger ikke analogReference(...).
+// values: Konverteringer kopieret fra skanningen i denne cyklus.
+// isSetup: Holder styr på hvilke porte der er konfigureret. Gennemløb koster efter antal porte i brug.
+// setPort(...): Mapper portNo, opkobler Arduino, læser første værdi og tilføjer porten til skanningen.
+// setFilter(...): Sætter filter for en konfigureret port.
+// doClockCycle(...): Kopierer seneste konverteringer.
+// read(...): Leverer driverens nuværende værdi.
+class t_AnalogScanInDrv: public t_InputDriver {
+private:
+  int values[MaxNoInAnlPorts];
+  t_PortSet<MaxNoInAnlPorts> isSetup;
+public:
+  t_AnalogScanInDrv(void) {}
+  void setPort(unsigned int portNo, byte pin);
+  void setFilter(unsigned int portNo, byte smoothing, byte extraBits=0);
+  void doClockCycle();
+  bool read(unsigned int portNo, int *value);
+};
+#endif
+
 /*
  * CPP kode herunder
  */
 
+// Filter for analog indgang
+
+void t_AnalogFilter::setFilter(byte smoothing, byte extraBits) {
+  int raw = dataOut() >> this->extraBits;
+  this->smoothing = (smoothing < MaxSmoothing)? smoothing: (byte)MaxSmoothing;
+  this->extraBits = (extraBits < MaxExtraBits)? extraBits: (byte)MaxExtraBits;
+  reset(raw);
+}
+
+void t_AnalogFilter::reset(int raw) {
+  noSamples = 0;
+  sum = 0;
+  state = ((unsigned long)raw << extraBits) << smoothing;
+}
+
+bool t_AnalogFilter::sample(int raw) {
+  sum += raw;
+  if (++noSamples < (1 << (2*extraBits))) return false;
+  state += (sum >> extraBits) - (state >> smoothing);
+  noSamples = 0;
+  sum = 0;
+  return true;
+}
+
+//----------
+
 // 1 analog input port
 
 void t_AnalogParrInPort::setPort(byte pin) {
   this->pin = pin;
-  value = analogRead(pin);
+  filter.reset(analogRead(pin));
+  value = filter.dataOut();
+}
+
+void t_AnalogParrInPort::setFilter(byte smoothing, byte extraBits) {
+  filter.setFilter(smoothing, extraBits);
+  value = filter.dataOut();
 }
 
 bool t_AnalogParrInPort::read(int *value) {
@@ -92,15 +225,26 @@ bool t_AnalogParrInPort::read(int *value) {
 void t_AnalogParrInDrv::setPort(unsigned int portNo, byte pin) {
   if (isValidIndex(portNo, MaxNoInAnlPorts)==true) {
     ports[portNo].setPort(pin);
-    isSetup[portNo] = true;   
+    isSetup.add(portNo);
   }
 }
 
+void t_AnalogParrInDrv::setFilter(unsigned int portNo, byte smoothing, byte extraBits) {
+  if (hasConfig(isSetup, portNo, MaxNoInAnlPorts) == true) ports[portNo].setFilter(smoothing, extraBits);
+}
+
+// Analoge porte har ingen bit i øjebliksbilledet. Skift er ændring af værdien.
 void t_AnalogParrInDrv::doClockCycle() {
+  int lastValue, value;
   unsigned int portNo;
-  for (portNo=0; portNo < MaxNoInAnlPorts; portNo++) {
-    if (isSetup[portNo] == true) ports[portNo].doClockCycle();
+  unsigned long nextChangedBits = 0;
+  for (portNo=isSetup.next(0); portNo < MaxNoInAnlPorts; portNo=isSetup.next(portNo+1)) {
+    ports[portNo].read(&lastValue);
+    ports[portNo].doClockCycle();
+    ports[portNo].read(&value);
+    if ((value != lastValue) && (portNo < MaxSnapshotPorts)) nextChangedBits |= 1UL << portNo;
   }
+  publishChanges(nextChangedBits);
 }
 
 bool t_AnalogParrInDrv::read(unsigned int portNo, int *value) {
@@ -109,4 +253,93 @@ bool t_AnalogParrInDrv::read(unsigned int portNo, int *value) {
   return validRead;
 }
 
+//----------
+
+#if (defined(__AVR__) || defined(ARDUINO_HOSTSIM)) && defined(JB_ADC_SCAN)
+// Skanning med A/D konverterens interrupt
+
+// Kanal 8-15 på Arduino Mega vælges med MUX5
+void AdcScan::select(byte channel) {
+  ADMUX = (1 << REFS0) | (channel & 0x07);
+#ifdef MUX5
+  ADCSRB = (channel > 7)? (ADCSRB | (1 << MUX5)): (ADCSRB & ~(1 << MUX5));
+#endif
+  ADCSRA |= 1 << ADSC;
+}
+
+// Prescaler 128 som for analogRead. ADIF nulstilles ved at skrive 1.
+void AdcScan::start(void) {
+  if (noChannels == 0) return;
+  current = 0;
+  ADCSRA = (1 << ADEN) | (1 << ADIF) | (1 << ADIE) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+  select(channels[scanPorts[0]]);
+}
+
+void AdcScan::stop(void) {
+  ADCSRA &= ~(1 << ADIE);
+  while ((ADCSRA & (1 << ADSC)) != 0) delayMicroseconds(10);
+}
+
+ISR(ADC_vect) {
+  byte portNo = AdcScan::scanPorts[AdcScan::current];
+  if (AdcScan::filters[portNo].sample(ADC) == true) AdcScan::results[portNo] = AdcScan::filters[portNo].dataOut();
+  if (++AdcScan::current == AdcScan::noChannels) AdcScan::current = 0;
+  AdcScan::select(AdcScan::channels[AdcScan::scanPorts[AdcScan::current]]);
+}
+
+//----------
+
+// Samling af analoge input porte med skanning
+
+// Skanningen stoppes, så analogRead kan læse første værdi. En anden samling end ejeren afvises.
+void t_AnalogScanInDrv::setPort(unsigned int portNo, byte pin) {
+  if (isValidIndex(portNo, MaxNoInAnlPorts) == false) return;
+  if (AdcScan::owner == nullptr) AdcScan::owner = this;
+  if (AdcScan::owner != this) return;
+  AdcScan::stop();
+  AdcScan::filters[portNo].reset(analogRead(pin));
+  values[portNo] = AdcScan::results[portNo] = AdcScan::filters[portNo].dataOut();
+  AdcScan::channels[portNo] = (pin >= A0)? pin-A0: pin;
+  if (isSetup.has(portNo) == false) AdcScan::scanPorts[AdcScan::noChannels++] = portNo;
+  isSetup.add(portNo);
+  AdcScan::start();
+}
+
+// Filteret deles med interrupt rutinen og sættes med interrupt slået fra.
+void t_AnalogScanInDrv::setFilter(unsigned int portNo, byte smoothing, byte extraBits) {
+  if (hasConfig(isSetup, portNo, MaxNoInAnlPorts) == false) return;
+  noInterrupts();
+  AdcScan::filters[portNo].setFilter(smoothing, extraBits);
+  values[portNo] = AdcScan::results[portNo] = AdcScan::filters[portNo].dataOut();
+  interrupts();
+}
+
+// Et int skrives i 2 trin af interrupt rutinen. Derfor kopieres med interrupt slået fra.
+// Skanningens liste over porte bruges til gennemløb, så prisen følger antal porte i brug.
+void t_AnalogScanInDrv::doClockCycle() {
+  int results[MaxNoInAnlPorts];
+  byte cnt, portNo;
+  unsigned long nextChangedBits = 0;
+  if (AdcScan::owner != this) return;
+  noInterrupts();
+  for (cnt=0; cnt < AdcScan::noChannels; cnt++) results[cnt] = AdcScan::results[AdcScan::scanPorts[cnt]];
+  interrupts();
+  for (cnt=0; cnt < AdcScan::noChannels; cnt++) {
+    portNo = AdcScan::scanPorts[cnt];
+    if ((results[cnt] != values[portNo]) && (portNo < MaxSnapshotPorts)) nextChangedBits |= 1UL << portNo;
+    values[portNo] = results[cnt];
+  }
+  publishChanges(nextChangedBits);
+}
+
+bool t_AnalogScanInDrv::read(unsigned int portNo, int *value) {
+  bool validRead = false;
+  if ((hasConfig(isSetup, portNo, MaxNoInAnlPorts) == true) && (value != nullptr)) {
+    *value = values[portNo];
+    validRead = true;
+  }
+  return validRead;
+}
+#endif
+
 #endif
@@ -0,0 +1,191 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Dæmpbar output driver
+ * Version: 1.1
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Dæmpbar output driver".
+ *
+ * "Dæmpbar output driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Dæmpbar output driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Dæmpbar output driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.1: Timeren sættes først i interrupt rutinen, og korteste tidsrum er 16 mikrosek. Billeder afleveres efter en barriere.
+ * Applikationen erklærer MaxNoOutBamPorts før biblioteket inkluderes.
+ * Biblioteket definerer interrupt rutinen TIMER2_COMPA_vect. Det kan derfor ikke bruges sammen med andre biblioteker,
+ * der bruger timer 2, f.eks. tone(). PWM på pin 3 og 11 med analogWrite kan heller ikke bruges.
+ * Der kan kun være en driver i en applikation.
+ */
+
+#ifndef JBBamOutDrv_h
+#define JBBamOutDrv_h
+
+#if !defined(__AVR__) && !defined(ARDUINO_HOSTSIM)
+#error "JBBamOutDrv kræver AVR med timer 2"
+#endif
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <JBKernel.h>
+#include <JBOutputDriver.h>
+
+// Ansvar: Udlæser lysstyrke med bit angle modulation (BAM) fra interrupt rutinen for timer 2.
+// En periode er delt i et tidsrum per bit i lysstyrken. Tidsrummet for bit n varer 2^n enheder, og udgange med bit n sat er høje.
+// Interrupt rutinen skriver et færdigt billede af hvert port register, så dens tid vokser med antal bits og ikke med antal udgange.
+// Driveren bygger billederne i en buffer, som interrupt rutinen skifter til i starten af næste periode.
+// NoBits: Antal bits i lysstyrken.
+// MaxNoRegs: Antal port registre. Arduino Uno har 3, Arduino Mega har 11.
+// TicksPerUnit: Tællinger af timer 2 i det korteste tidsrum. Med prescaler 128 er en tælling 8 mikrosek.
+//   Det korteste tidsrum er 16 mikrosek, dvs. 256 CPU cyklusser. Det giver plads til, at andre interrupt rutiner
+//   forsinker starten af interrupt rutinen. Perioden er 2*255*8 mikrosek = 4,08 msek, dvs. 245 Hz.
+// outRegs: Port registre med udgange.
+// ownMasks: Driverens bits i hvert port register.
+// noRegs: Antal port registre i brug.
+// slices: To buffere med billede af hvert port register for hvert bit.
+// active: Buffer som interrupt rutinen bruger.
+// isPending: Den anden buffer er klar og tages i brug i starten af næste periode.
+// bitNo: Bit som næste interrupt udlæser.
+namespace Bam {
+  const byte NoBits = 8;
+  const byte MaxNoRegs = (MaxNoOutBamPorts < 11)? MaxNoOutBamPorts: 11;
+  const byte TicksPerUnit = 2;
+  static volatile uint8_t *outRegs[MaxNoRegs];
+  static byte ownMasks[MaxNoRegs];
+  static byte noRegs=0;
+  static byte slices[2][NoBits][MaxNoRegs];
+  static volatile byte active=0;
+  static volatile bool isPending=false;
+  static volatile byte bitNo=0;
+}
+
+//----------
+
+// Ansvar: Samling af dæmpbare udgange.
+// Lysstyrke er 0-255 som i analogWrite. En binær værdi giver slukket eller fuld lysstyrke.
+// Billederne bygges kun i cyklusser, hvor en lysstyrke er ændret.
+// levels: Lysstyrke for hver udgang.
+// regNo: Index til udgangens port register.
+// bitMask: Udgangens bit i port registret.
+// isSetup: Holder styr på hvilke udgange der er konfigureret.
+// isDirty: Om en lysstyrke er ændret, siden billederne sidst blev bygget.
+// build(...): Bygger billeder i den buffer, som interrupt rutinen ikke bruger.
+// begin(...): Starter timer 2.
+// setPort(...): Opkobler Arduino og konfigurerer udgangen.
+// write(...): Skriver lysstyrke eller binær værdi.
+// doClockCycle(...): Bygger nye billeder, hvis en lysstyrke er ændret.
+class t_BamOutDrv: public t_OutputDriver {
+private:
+  byte levels[MaxNoOutBamPorts];
+  byte regNo[MaxNoOutBamPorts];
+  byte bitMask[MaxNoOutBamPorts];
+  t_PortSet<MaxNoOutBamPorts> isSetup;
+  bool isDirty;
+  void build(void);
+public:
+  t_BamOutDrv(void): isDirty(false) {}
+  void begin(void);
+  void setPort(unsigned int portNo, byte pin, int value=0);
+  void write(unsigned int portNo, bool value) {write(portNo, (value == LOW)? 0: 255);}
+  void write(unsigned int portNo, int value);
+  void doClockCycle(void) {if ((isDirty == true) && (Bam::isPending == false)) build();}
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// Bit angle modulation
+
+// Timeren sættes først til tidsrummet for bittet. Ellers kan tælleren i det korteste tidsrum nå forbi compare værdien,
+// før den er skrevet, og tidsrummet varer en hel omgang af timeren. Derefter udlæses billedet for bittet.
+ISR(TIMER2_COMPA_vect) {
+  OCR2A = (Bam::TicksPerUnit << Bam::bitNo)-1;
+  if ((Bam::bitNo == 0) && (Bam::isPending == true)) {
+    Bam::active ^= 1;
+    Bam::isPending = false;
+  }
+  byte *slice = Bam::slices[Bam::active][Bam::bitNo];
+  for (byte cnt=0; cnt < Bam::noRegs; cnt++) {
+    *Bam::outRegs[cnt] = (*Bam::outRegs[cnt] & ~Bam::ownMasks[cnt]) | slice[cnt];
+  }
+  Bam::bitNo = (Bam::bitNo+1) & (Bam::NoBits-1);
+}
+
+//----------
+
+// Samling af dæmpbare udgange
+
+// Timer 2 i CTC med prescaler 128
+void t_BamOutDrv::begin(void) {
+  noInterrupts();
+  TCCR2A = 1 << WGM21;
+  TCCR2B = (1 << CS22) | (1 << CS20);
+  TCNT2 = 0;
+  OCR2A = Bam::TicksPerUnit-1;
+  TIMSK2 = 1 << OCIE2A;
+  interrupts();
+}
+
+// Et nyt port register gøres klar, før det tælles med, så interrupt rutinen aldrig ser et halvt registreret register.
+void t_BamOutDrv::setPort(unsigned int portNo, byte pin, int value) {
+  if (isValidIndex(portNo, MaxNoOutBamPorts) == false) return;
+  volatile uint8_t *outReg = portOutputRegister(digitalPinToPort(pin));
+  byte cnt;
+  for (cnt=0; (cnt < Bam::noRegs) && (Bam::outRegs[cnt] != outReg); cnt++);
+  if (cnt == Bam::noRegs) {
+    if (Bam::noRegs == Bam::MaxNoRegs) return;
+    Bam::outRegs[cnt] = outReg;
+    Bam::ownMasks[cnt] = 0;
+    for (byte bitNo=0; bitNo < Bam::NoBits; bitNo++) Bam::slices[0][bitNo][cnt] = Bam::slices[1][bitNo][cnt] = 0;
+    Bam::noRegs++;
+  }
+  regNo[portNo] = cnt;
+  bitMask[portNo] = digitalPinToBitMask(pin);
+  Bam::ownMasks[cnt] |= bitMask[portNo];
+  isSetup.add(portNo);
+  digitalWrite(pin, LOW);
+  pinMode(pin, OUTPUT);
+  levels[portNo] = 0;
+  write(portNo, value);
+}
+
+void t_BamOutDrv::write(unsigned int portNo, int value) {
+  if (hasConfig(isSetup, portNo, MaxNoOutBamPorts) == false) return;
+  byte level = constrain(value, 0, 255);
+  if (level == levels[portNo]) return;
+  levels[portNo] = level;
+  isDirty = true;
+}
+
+void t_BamOutDrv::build(void) {
+  byte (*slices)[Bam::MaxNoRegs] = Bam::slices[Bam::active ^ 1];
+  for (byte bitNo=0; bitNo < Bam::NoBits; bitNo++) {
+    for (byte cnt=0; cnt < Bam::noRegs; cnt++) slices[bitNo][cnt] = 0;
+  }
+  for (unsigned int portNo=isSetup.next(0); portNo < MaxNoOutBamPorts; portNo=isSetup.next(portNo+1)) {
+    byte level = levels[portNo];
+    for (byte bitNo=0; (bitNo < Bam::NoBits) && (level != 0); bitNo++, level >>= 1) {
+      if ((level & 1) != 0) slices[bitNo][regNo[portNo]] |= bitMask[portNo];
+    }
+  }
+  isDirty = false;
+  // noInterrupts og interrupts er barrierer for compileren, så billederne er skrevet, før interrupt rutinen får dem
+  noInterrupts();
+  Bam::isPending = true;
+  interrupts();
+}
+
+#endif
@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Styrenheder
- * Version: 1.3
+ * Version: 1.10
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 20-04-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Styrenheder".
  * 
@@ -26,6 +26,13 @@
  * Version 1.1: Styreenhed med blink: Ved sluk, slukkede udgang ikke men gik på fast lys. Det er rettet til sluk.
  * Version 1.2: Styreenhed med blink rettet færdigt.
  * Version 1.3: Styreenhed med blink. Metode to optimeret, tjek for driver initialiseret er fjernet.
+ * Version 1.4: Standardværdi for argument er fjernet fra definition af metode begin. Den gav fejl ved oversættelse.
+ * Version 1.5: Styreenhed med blink kan følge en kanal i multivibrator.
+ * Version 1.6: Styreenhed med blød tænd og sluk og fælles motor for ramper.
+ * Version 1.7: Styreenhed med blink skriver kun ved skift og abonnerer på skift i blinkeren.
+ * Version 1.8: Styrenhed med blød tænd og sluk kalder selv motoren for ramper. Tjek for driver i begin.
+ * Version 1.9: Styrenhed med blink kan ikke kopieres og afmelder sig motoren, når den nedlægges.
+ * Version 1.10: Styrenhed med blød tænd og sluk kan ikke kopieres og tages ud af motoren, når den nedlægges.
  */
 
 #ifndef JBCtrlUnits_h
@@ -68,16 +75,122 @@ public:
 
 //----------
 
+class t_WithBlinkOut;
+
+// Ansvar: Fælles motor for styrenheder med blink. Styrenheder abonnerer på skift i deres blinker, mens de blinker.
+// Hver styrenhed kender taktslaget for sit næste skift, og motoren kender det tidligste. I en cyklus uden skift
+// koster motoren en sammenligning, og styrenhederne skriver kun til driveren, når deres udgang skifter.
+// NoEdge: Afstand til næste skift for en blinker, der ikke skifter.
+// head: Kæde af styrenheder der blinker
+// nextEdge: Taktslag for tidligste skift
+// subscribe(...): Sætter styrenhed i kæden
+// unsubscribe(...): Tager styrenhed ud af kæden
+// doClockCycle(...): Behandler styrenheder med skift i denne cyklus. Kaldes en gang per cyklus.
+namespace BlinkEvents {
+  const unsigned long NoEdge = 0x7FFFFFFF;
+  static t_WithBlinkOut *head=nullptr;
+  static unsigned long nextEdge=0;
+  void subscribe(t_WithBlinkOut *unit);
+  void unsubscribe(t_WithBlinkOut *unit);
+  void doClockCycle(void);
+}
+
 // Ansvar: Styrenhed med blink.
+// Udgangen skrives kun, når den skifter. Styrenheden abonnerer på sin blinker, mens den blinker.
+// next, prev: Kæde af styrenheder i motoren
+// nextEdge: Taktslag for næste skift i blinkeren
+// blinkerNo: Blinker eller kanal i multivibrator som styrenheden følger
+// isSubscribed: Styrenheden er i motoren
+// isRetry: Blinkeren skiftede ikke til tiden, og der ses efter igen i næste cyklus
+// level: Udgangens niveau
+// schedule(...): Beregner taktslag for næste skift
+// edge(...): Aflæser blinkeren og skriver udgangen, hvis den skifter
 // begin(...): Initialiserer styrenheden
-// doClockCycle(...): Styrenheder med tidsstyring opdateres i hver klokkescyklus
+// doClockCycle(...): Kalder motoren. Applikationer med mange styrenheder kan i stedet kalde motoren en gang per cyklus.
 // to(...): Modtager styreenheds næste tilstand
+// Styrenheden sidder i en kæde i motoren. Den kan derfor ikke kopieres og tages ud af motoren, når den nedlægges.
 class t_WithBlinkOut: public t_CtrlUnit {
+private:
+  t_WithBlinkOut *next;
+  t_WithBlinkOut *prev;
+  unsigned long nextEdge;
+  byte blinkerNo;
+  bool isSubscribed;
+  bool isRetry;
+  bool level;
+  void schedule(void);
+  void edge(void);
+  friend void BlinkEvents::subscribe(t_WithBlinkOut *unit);
+  friend void BlinkEvents::unsubscribe(t_WithBlinkOut *unit);
+  friend void BlinkEvents::doClockCycle(void);
 public:
-  t_WithBlinkOut(void) {}
-  void begin(t_OutputDriver *driver, unsigned int portNo, byte state=OFF);
+  t_WithBlinkOut(void): blinkerNo(MASTERBLINKERNO), isSubscribed(false), isRetry(false), level(LOW) {}
+  t_WithBlinkOut(const t_WithBlinkOut &)=delete;
+  t_WithBlinkOut &operator=(const t_WithBlinkOut &)=delete;
+  ~t_WithBlinkOut(void) {BlinkEvents::unsubscribe(this);}
+  void begin(t_OutputDriver *driver, unsigned int portNo, byte state=OFF, byte blinkerNo=MASTERBLINKERNO);
+  void doClockCycle(void) {BlinkEvents::doClockCycle();}
+  void to(byte state);
+};
+
+//----------
+
+class t_FadeOut;
+
+// Ansvar: Fælles motor for ramper på dæmpbare udgange. Kun styrenheder med en aktiv rampe er i motoren.
+// Styrenheder der står stille, koster derfor intet i en cyklus. Hver styrenhed kalder motoren fra sin doClockCycle,
+// og motoren flytter kun ramperne en gang per taktslag.
+// head: Kæde af styrenheder med en aktiv rampe
+// lastTick: Taktslag hvor ramperne sidst blev flyttet
+// insert(...): Sætter styrenhed i kæden
+// remove(...): Tager styrenhed ud af kæden
+// doClockCycle(...): Flytter alle aktive ramper et skridt
+namespace Fader {
+  static t_FadeOut *head=nullptr;
+  static unsigned long lastTick=0xFFFFFFFF;
+  void insert(t_FadeOut *unit);
+  void remove(t_FadeOut *unit);
   void doClockCycle(void);
-  void to(byte state) {this->state = state;}
+}
+
+// Ansvar: Styrenhed med blød tænd og sluk, f.eks. til at efterligne en glødepære med en LED.
+// Udgangen skrives med lysstyrke 0-255 og skal derfor sidde på en dæmpbar output driver.
+// Lysstyrken er et fast komma tal med 8 bits efter kommaet, så langsomme ramper også flytter sig jævnt.
+// Ved blink følger lysstyrken blinkeren med samme ramper og styrenheden bliver i motoren.
+// next, prev: Kæde af styrenheder i motoren
+// isActive: Styrenheden er i motoren
+// level: Nuværende lysstyrke i fast komma
+// stepUp: Skridt per cyklus når lyset tændes
+// stepDown: Skridt per cyklus når lyset slukkes
+// blinkerNo: Blinker eller kanal i multivibrator som styrenheden følger
+// calcStep(...): Beregner skridt for en rampe med en varighed i msek
+// ramp(...): Flytter lysstyrken et skridt. Returnerer true, når rampen er færdig.
+// begin(...): Initialiserer styrenheden
+// doClockCycle(...): Kalder motoren for ramper
+// to(...): Modtager styreenheds næste tilstand
+// Styrenheden sidder i en kæde i motoren. Den kan derfor ikke kopieres og tages ud af motoren, når den nedlægges.
+class t_FadeOut: public t_CtrlUnit {
+private:
+  t_FadeOut *next;
+  t_FadeOut *prev;
+  bool isActive;
+  word level;
+  word stepUp;
+  word stepDown;
+  byte blinkerNo;
+  static word calcStep(unsigned int fadeTime);
+  bool ramp(void);
+  friend void Fader::insert(t_FadeOut *unit);
+  friend void Fader::remove(t_FadeOut *unit);
+  friend void Fader::doClockCycle(void);
+public:
+  t_FadeOut(void): isActive(false), level(0), blinkerNo(MASTERBLINKERNO) {}
+  t_FadeOut(const t_FadeOut &)=delete;
+  t_FadeOut &operator=(const t_FadeOut &)=delete;
+  ~t_FadeOut(void) {Fader::remove(this);}
+  void begin(t_OutputDriver *driver, unsigned int portNo, unsigned int fadeInTime, unsigned int fadeOutTime, byte state=OFF, byte blinkerNo=MASTERBLINKERNO);
+  void doClockCycle(void) {Fader::doClockCycle();}
+  void to(byte state);
 };
 
 /*
@@ -95,7 +208,7 @@ void t_CtrlUnit::setPort(t_OutputDriver *driver, unsigned int portNo) {
 
 // Styrenhed med tænd og sluk
 
-void t_OnOffOut::begin(t_OutputDriver *driver, unsigned int portNo, byte state=OFF) {
+void t_OnOffOut::begin(t_OutputDriver *driver, unsigned int portNo, byte state) {
   setPort(driver, portNo);
   to(state);
 }
@@ -109,17 +222,159 @@ void t_OnOffOut::to(byte state) {
 
 //----------
 
+// Motor for blink
+
+// Sammenligningen tåler at tælleren af taktslag løber rundt
+void BlinkEvents::subscribe(t_WithBlinkOut *unit) {
+  if (unit->isSubscribed == true) return;
+  unit->prev = nullptr;
+  unit->next = head;
+  if (head != nullptr) head->prev = unit;
+  head = unit;
+  unit->isSubscribed = true;
+  if ((unit->next == nullptr) || ((long)(unit->nextEdge-nextEdge) < 0)) nextEdge = unit->nextEdge;
+}
+
+void BlinkEvents::unsubscribe(t_WithBlinkOut *unit) {
+  if (unit->isSubscribed == false) return;
+  if (unit->prev != nullptr) unit->prev->next = unit->next;
+  else head = unit->next;
+  if (unit->next != nullptr) unit->next->prev = unit->prev;
+  unit->isSubscribed = false;
+}
+
+// Kun i cyklusser med skift gennemløbes kæden, og det tidligste skift findes igen
+void BlinkEvents::doClockCycle(void) {
+  t_WithBlinkOut *unit;
+  if ((head == nullptr) || ((long)(Clock::ticks-nextEdge) < 0)) return;
+  nextEdge = Clock::ticks+NoEdge;
+  for (unit = head; unit != nullptr; unit = unit->next) {
+    if ((long)(Clock::ticks-unit->nextEdge) >= 0) unit->edge();
+    if ((long)(unit->nextEdge-nextEdge) < 0) nextEdge = unit->nextEdge;
+  }
+}
+
+//----------
+
 // Styrenhed med blink
 
-void t_WithBlinkOut::begin(t_OutputDriver *driver, unsigned int portNo, byte state=OFF) {
+void t_WithBlinkOut::begin(t_OutputDriver *driver, unsigned int portNo, byte state, byte blinkerNo) {
   setPort(driver, portNo);
+  this->blinkerNo = blinkerNo;
+  level = LOW;
+  if (driver == nullptr) return;
+  driver->write(portNo, level);
+  to(state);
+}
+
+void t_WithBlinkOut::to(byte state) {
+  if (driver == nullptr) return;
   this->state = state;
+  if (state == BLINK) {
+    if (isSubscribed == true) return;
+    isRetry = false;
+    edge();
+    BlinkEvents::subscribe(this);
+  }
+  else {
+    BlinkEvents::unsubscribe(this);
+    if (level == HIGH) driver->write(portNo, level = LOW);
+  }
+}
+
+void t_WithBlinkOut::schedule(void) {
+  unsigned long noCycles = blinkerNextEdge(blinkerNo);
+  nextEdge = Clock::ticks+((noCycles == 0)? BlinkEvents::NoEdge: noCycles);
+}
+
+// En blinker der ikke har skiftet til tiden, f.eks. fordi den opdateres senere i cyklussen, aflæses igen i næste cyklus
+void t_WithBlinkOut::edge(void) {
+  bool nextLevel = blinkerNotification(blinkerNo);
+  if (nextLevel != level) {
+    driver->write(portNo, level = nextLevel);
+    isRetry = false;
+    schedule();
+  }
+  else if ((isRetry == false) && (isSubscribed == true)) {
+    isRetry = true;
+    nextEdge = Clock::ticks+1;
+  }
+  else {
+    isRetry = false;
+    schedule();
+  }
+}
+
+//----------
+
+// Motor for ramper
+
+void Fader::insert(t_FadeOut *unit) {
+  if (unit->isActive == true) return;
+  unit->prev = nullptr;
+  unit->next = head;
+  if (head != nullptr) head->prev = unit;
+  head = unit;
+  unit->isActive = true;
+}
+
+void Fader::remove(t_FadeOut *unit) {
+  if (unit->isActive == false) return;
+  if (unit->prev != nullptr) unit->prev->next = unit->next;
+  else head = unit->next;
+  if (unit->next != nullptr) unit->next->prev = unit->prev;
+  unit->isActive = false;
+}
+
+// Flere styrenheder kalder motoren i samme taktslag, men ramperne flyttes kun ved det første kald
+void Fader::doClockCycle(void) {
+  t_FadeOut *unit;
+  t_FadeOut *next;
+  if ((head == nullptr) || (lastTick == Clock::ticks)) return;
+  lastTick = Clock::ticks;
+  for (unit = head; unit != nullptr; unit = next) {
+    next = unit->next;    // Styrenheden kan blive taget ud af kæden
+    if (unit->ramp() == true) remove(unit);
+  }
 }
 
-void t_WithBlinkOut::doClockCycle(void) {
+//----------
+
+// Styrenhed med blød tænd og sluk
+
+// Hele spændet fra 0 til 255 fordeles på rampens cyklusser. Uden varighed skifter lyset i en cyklus.
+word t_FadeOut::calcStep(unsigned int fadeTime) {
+  unsigned long noCycles = Clock::convertToClockCycles(fadeTime);
+  if (noCycles == 0) noCycles = 1;
+  unsigned long step = (255UL << 8)/noCycles;
+  return (step == 0)? 1: step;
+}
+
+void t_FadeOut::begin(t_OutputDriver *driver, unsigned int portNo, unsigned int fadeInTime, unsigned int fadeOutTime, byte state, byte blinkerNo) {
+  setPort(driver, portNo);
+  stepUp = calcStep(fadeInTime);
+  stepDown = calcStep(fadeOutTime);
+  this->blinkerNo = blinkerNo;
+  level = (state == ON)? (255 << 8): 0;
   if (driver == nullptr) return;
-  bool driverState = (state == BLINK)? blinkerNotification(MASTERBLINKERNO): LOW;
-  driver->write(portNo, driverState);
+  driver->write(portNo, (int)(level >> 8));
+  to(state);
+}
+
+void t_FadeOut::to(byte state) {
+  if (driver == nullptr) return;
+  this->state = state;
+  Fader::insert(this);
+}
+
+bool t_FadeOut::ramp(void) {
+  bool isLit = (state == ON) || ((state == BLINK) && (blinkerNotification(blinkerNo) == ON));
+  word target = (isLit == true)? (255 << 8): 0;
+  byte lastLevel = level >> 8;
+  if (level < target) level = (target-level > stepUp)? level+stepUp: target;
+  else if (level > target) level = (level-target > stepDown)? level-stepDown: target;
+  if ((level >> 8) != lastLevel) driver->write(portNo, (int)(level >> 8));
+  return (level == target) && (state != BLINK);
 }
 
 #endif
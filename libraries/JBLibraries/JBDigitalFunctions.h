@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Digitale funktioner
- * Version: 1.0
+ * Version: 1.5
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 21-02-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Digitale funktioner".
  * 
@@ -23,6 +23,11 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Oversat kæde af digitale funktioner uden virtuelle kald.
+ * Version 1.2: Digitale funktioner for 32 signaler på en gang.
+ * Version 1.3: Tidsfunktioner med fælles liste over frister.
+ * Version 1.4: Egne digitale funktioner behøver ikke opCode. En kæde der ikke kan oversættes, beregnes som objekterne af t_FunctionChain.
+ * Version 1.5: Tidsfunktioner tælles af tidshjulet. Listen over frister er fjernet, og tidsfunktioner kan ikke kopieres.
  */
 
 #ifndef JBDigitalFunctions_h
@@ -33,6 +38,10 @@
 
 // Erklæring af flanketyper
 enum EdgeTypes {EDGEDOWN, EDGEUP};
+// Erklæring af funktioner i en oversat kæde. FCT_TIMED og FCT_OBJECT kan ikke oversættes.
+enum FunctionOps {FCT_NEGATE, FCT_EDGEDOWN, FCT_EDGEUP, FCT_REGISTER, FCT_TOGGLE, FCT_TIMED, FCT_OBJECT};
+
+class t_FunctionChain;
 
 //----------
 
@@ -42,15 +51,18 @@ enum EdgeTypes {EDGEDOWN, EDGEUP};
 // setDigitalFct(...): Sætter pointer til næste digitale funktion
 // reset(...): Resetter den digitale funktion
 // dataOut(...): Beregner og leverer resultat af funktionen.
+// opCode(...): Leverer funktionen i en oversat kæde. Egne funktioner kan ikke oversættes og beregnes som objekter.
 class t_DigitalFunction {
 protected:
   bool value;
   t_DigitalFunction *digitalFunction;
+  friend class t_FunctionChain;
 public:
   t_DigitalFunction(void) : digitalFunction(nullptr) {}
   void setDigitalFunction(t_DigitalFunction *nextDigitalFct);
   virtual void reset(void);
   virtual bool dataOut(bool value)=0;
+  virtual FunctionOps opCode(void) const {return FCT_OBJECT;}
 };
 
 //----------
@@ -61,6 +73,7 @@ class t_Negator : public t_DigitalFunction {
 public:
   t_Negator(void){}
   bool dataOut(bool value);
+  FunctionOps opCode(void) const {return FCT_NEGATE;}
 };
 
 //----------
@@ -75,6 +88,7 @@ public:
   t_EdgeDetector(void): edgeType(EDGEDOWN) {value = OFF;}
   void begin(bool startValue, EdgeTypes edgeType);
   bool dataOut(bool value);
+  FunctionOps opCode(void) const {return (edgeType == EDGEDOWN)? FCT_EDGEDOWN: FCT_EDGEUP;}
 };
 
 //----------
@@ -89,6 +103,7 @@ public:
   void begin(bool startValue);
   bool dataOut(bool value);
   void reset(void);
+  FunctionOps opCode(void) const {return FCT_REGISTER;}
 };
 
 //----------
@@ -101,6 +116,155 @@ public:
   t_Toggle(void) {value = OFF;}
   void begin(bool startValue);
   bool dataOut(bool value);
+  FunctionOps opCode(void) const {return FCT_TOGGLE;}
+};
+
+//----------
+
+// Ansvar: Grænseflade for digitale funktioner med tid. Tiden tælles ikke af funktionen, men af tidshjulet.
+// Tidsfunktioner kan ikke oversættes til en kæde og beregnes som objekter.
+// Timeren sidder i tidshjulet. Tidsfunktionen kan derfor ikke kopieres, og timeren tages ud af hjulet, når den nedlægges.
+// timer: Timer i tidshjulet
+// duration: Varighed
+// inSeconds: Varigheden er i sekunder
+// isArmed: Timeren tæller
+// isExpired: Tiden er udløbet siden sidste start
+// update(...): Henter udløb fra timeren. Kaldes først i dataOut.
+// arm(...): Starter tiden forfra
+// cancel(...): Stopper tiden
+// forward(...): Leverer resultat videre til næste digitale funktion
+// begin(...): Initialiserer varighed
+// opCode(...): Tidsfunktioner findes ikke i en oversat kæde.
+class t_TimedFunction : public t_DigitalFunction {
+private:
+  t_WheelTimer timer;
+  unsigned int duration;
+  bool inSeconds;
+protected:
+  bool isArmed;
+  bool isExpired;
+  void update(void);
+  void arm(void);
+  void cancel(void);
+  bool forward(bool value) {return (digitalFunction != nullptr)? digitalFunction->dataOut(value): value;}
+public:
+  t_TimedFunction(void): duration(0), inSeconds(MSEC), isArmed(false), isExpired(false) {value = OFF;}
+  void begin(unsigned int duration, bool inSeconds = MSEC);
+  FunctionOps opCode(void) const {return FCT_TIMED;}
+};
+
+//----------
+
+// Ansvar: Tilkoblingsforsinkelse (TON). Bliver ON, når indgangen har været ON i varigheden, og OFF med det samme.
+// dataOut(...): Beregner og leverer resultat af forsinkelsen.
+class t_OnDelay : public t_TimedFunction {
+public:
+  t_OnDelay(void) {}
+  bool dataOut(bool value);
+};
+
+//----------
+
+// Ansvar: Frakoblingsforsinkelse (TOF). Bliver ON med det samme og OFF, når indgangen har været OFF i varigheden.
+// dataOut(...): Beregner og leverer resultat af forsinkelsen.
+class t_OffDelay : public t_TimedFunction {
+public:
+  t_OffDelay(void) {}
+  bool dataOut(bool value);
+};
+
+//----------
+
+// Ansvar: Puls (TP). En stigende flanke giver ON i varigheden. Indgangen ignoreres, mens pulsen varer.
+// dataOut(...): Beregner og leverer resultat af pulsen.
+class t_Pulse : public t_TimedFunction {
+public:
+  t_Pulse(void) {}
+  bool dataOut(bool value);
+};
+
+//----------
+
+// Ansvar: Mindste tid for ON. Følger indgangen, men er ON i mindst varigheden fra den stigende flanke.
+// dataOut(...): Beregner og leverer resultat af funktionen.
+class t_MinOnTime : public t_TimedFunction {
+public:
+  t_MinOnTime(void) {}
+  bool dataOut(bool value);
+};
+
+//----------
+
+// Ansvar: Oversat kæde af digitale funktioner. Hver funktion er 1 byte med funktion og gemt værdi,
+// og kæden beregnes i en løkke uden virtuelle kald. Resultatet er det samme som kæden af objekter.
+// Kæden kan oversættes fra objekter eller bygges direkte, så objekterne ikke skal ligge i RAM.
+// En kæde af objekter der ikke kan oversættes, beregnes som objekterne, så resultatet er det samme.
+// MaxNoOps: Antal funktioner i en kæde.
+// OpMask: Bits med funktionen.
+// StateBit: Bit med den gemte værdi.
+// ops: Funktioner i rækkefølge.
+// noOps: Antal funktioner.
+// objects: Kæde af objekter der ikke kunne oversættes. nullptr når kæden er oversat eller bygget direkte.
+// clear(...): Tømmer kæden.
+// add(...): Tilføjer en funktion med startværdi. Returnerer false, hvis kæden er fuld, eller funktionen ikke kan oversættes.
+// compile(...): Oversætter kæde af objekter med deres nuværende værdier. En for lang kæde og en kæde med funktioner der
+//   ikke kan oversættes, f.eks. tidsfunktioner, beregnes i stedet som objekterne, og compile returnerer false.
+// reset(...): Resetter registre som i kæden af objekter.
+// dataOut(...): Beregner og leverer resultat af kæden.
+class t_FunctionChain {
+private:
+  enum {MaxNoOps=4, OpMask=0x07, StateBit=0x80};
+  byte ops[MaxNoOps];
+  byte noOps;
+  t_DigitalFunction *objects;
+public:
+  t_FunctionChain(void): noOps(0), objects(nullptr) {}
+  void clear(void) {noOps = 0; objects = nullptr;}
+  bool add(FunctionOps op, bool startValue=OFF);
+  bool compile(t_DigitalFunction *digitalFunction);
+  void reset(void);
+  bool dataOut(bool value);
+};
+
+//----------
+
+// Ansvar: Digitale funktioner for 32 signaler på en gang. Hvert signal er en bit i et ord, og hver funktion er
+// nogle få operationer på hele ordet. Prisen er derfor den samme for 1 som for 32 signaler.
+// Et signal løber igennem negator, flankedetektor, register og toggle i den rækkefølge. Masker vælger hvilke funktioner
+// hvert signal bruger. Funktionerne vælges med bits (1 << FCT_...) fra erklæringen af funktioner.
+// negateMask: Signaler der negeres.
+// edgeMask: Signaler med flankedetektor.
+// edgeUpMask: Signaler hvor flankedetektoren reagerer på stigende flanke. Ellers faldende.
+// registerMask: Signaler med register.
+// toggleMask: Signaler med toggle.
+// lastInputs: Flankedetektorernes forrige indgang.
+// registers: Registrenes værdi.
+// toggles: Toggles værdi.
+// value: Resultat af seneste beregning.
+// isStable: Samme indgange giver samme resultat igen. Falsk efter en flanke, når en toggle skifter og efter reset.
+// setLanes(...): Vælger funktioner og startværdi for en gruppe af signaler.
+// reset(...): Resetter registre for en gruppe af signaler.
+// dataOut(...): Beregner og leverer resultat for alle signaler. Uden argument leveres seneste resultat.
+// stable(...): Leverer om beregningen kan springes over, når indgangene er uændrede.
+class t_WordFunctions {
+private:
+  unsigned long negateMask;
+  unsigned long edgeMask;
+  unsigned long edgeUpMask;
+  unsigned long registerMask;
+  unsigned long toggleMask;
+  unsigned long lastInputs;
+  unsigned long registers;
+  unsigned long toggles;
+  unsigned long value;
+  bool isStable;
+public:
+  t_WordFunctions(void): negateMask(0), edgeMask(0), edgeUpMask(0), registerMask(0), toggleMask(0), lastInputs(0), registers(0), toggles(0), value(0), isStable(false) {}
+  void setLanes(unsigned long lanes, byte functions, unsigned long startValues=0);
+  void reset(unsigned long lanes=0xFFFFFFFF) {registers &= ~lanes; isStable = false;}
+  unsigned long dataOut(unsigned long inputs);
+  unsigned long dataOut(void) const {return value;}
+  bool stable(void) const {return isStable;}
 };
 
 /*
@@ -177,4 +341,163 @@ bool t_Toggle::dataOut(bool value) {
   return value;
 }
 
+//----------
+
+// Grænseflade til tidsfunktioner
+
+void t_TimedFunction::begin(unsigned int duration, bool inSeconds) {
+  cancel();
+  this->duration = duration;
+  this->inSeconds = inSeconds;
+}
+
+// Tidshjulet markerer timeren i det taktslag, hvor tiden udløber
+void t_TimedFunction::update(void) {
+  if (timer.triggered() == false) return;
+  isArmed = false;
+  isExpired = true;
+}
+
+// Uden varighed udløber timeren i næste taktslag
+void t_TimedFunction::arm(void) {
+  timer.start(duration, inSeconds);
+  isArmed = true;
+  isExpired = false;
+}
+
+void t_TimedFunction::cancel(void) {
+  timer.cancel();
+  isArmed = false;
+  isExpired = false;
+}
+
+//----------
+
+// Tilkoblingsforsinkelse
+
+bool t_OnDelay::dataOut(bool value) {
+  update();
+  if (value == OFF) cancel();
+  else if ((isArmed == false) && (isExpired == false)) arm();
+  return forward(isExpired);
+}
+
+//----------
+
+// Frakoblingsforsinkelse
+
+bool t_OffDelay::dataOut(bool value) {
+  update();
+  if (value == ON) cancel();
+  else if (this->value == ON) arm();
+  this->value = value;
+  return forward((value == ON) || (isArmed == true));
+}
+
+//----------
+
+// Puls
+
+bool t_Pulse::dataOut(bool value) {
+  update();
+  if ((this->value == OFF) && (value == ON) && (isArmed == false)) arm();
+  this->value = value;
+  return forward(isArmed);
+}
+
+//----------
+
+// Mindste tid for ON
+
+bool t_MinOnTime::dataOut(bool value) {
+  update();
+  if ((this->value == OFF) && (value == ON) && (isArmed == false)) arm();
+  this->value = value;
+  return forward((value == ON) || (isArmed == true));
+}
+
+//----------
+
+// Oversat kæde af digitale funktioner
+
+bool t_FunctionChain::add(FunctionOps op, bool startValue) {
+  if ((noOps == MaxNoOps) || (op == FCT_TIMED) || (op == FCT_OBJECT)) return false;
+  ops[noOps++] = op | ((startValue == ON)? StateBit: 0);
+  return true;
+}
+
+bool t_FunctionChain::compile(t_DigitalFunction *digitalFunction) {
+  clear();
+  for (const t_DigitalFunction *fct = digitalFunction; fct != nullptr; fct = fct->digitalFunction) {
+    if (add(fct->opCode(), fct->value) == false) {
+      clear();
+      objects = digitalFunction;
+      return false;
+    }
+  }
+  return true;
+}
+
+void t_FunctionChain::reset(void) {
+  if (objects != nullptr) {
+    objects->reset();
+    return;
+  }
+  for (byte cnt=0; cnt < noOps; cnt++) {
+    if ((ops[cnt] & OpMask) == FCT_REGISTER) ops[cnt] &= ~StateBit;
+  }
+}
+
+// Flankedetektor gemmer indgangen, register og toggle gemmer udgangen
+bool t_FunctionChain::dataOut(bool value) {
+  if (objects != nullptr) return objects->dataOut(value);
+  for (byte cnt=0; cnt < noOps; cnt++) {
+    byte op = ops[cnt];
+    bool last = (op & StateBit) != 0;
+    bool nextState = value;
+    switch (op & OpMask) {
+      case FCT_NEGATE: value = !value; continue;
+      case FCT_EDGEDOWN: value = last && !value; break;
+      case FCT_EDGEUP: value = !last && value; break;
+      case FCT_REGISTER: nextState = value = last || value; break;
+      case FCT_TOGGLE: nextState = value = last ^ value; break;
+    }
+    ops[cnt] = (op & OpMask) | ((nextState == true)? StateBit: 0);
+  }
+  return value;
+}
+
+//----------
+
+// Digitale funktioner for 32 signaler
+
+// Startværdien er flankedetektorens forrige indgang og værdien af register og toggle, som i begin for objekterne
+void t_WordFunctions::setLanes(unsigned long lanes, byte functions, unsigned long startValues) {
+  negateMask = ((functions & (1 << FCT_NEGATE)) != 0)? (negateMask | lanes): (negateMask & ~lanes);
+  edgeMask = ((functions & ((1 << FCT_EDGEDOWN) | (1 << FCT_EDGEUP))) != 0)? (edgeMask | lanes): (edgeMask & ~lanes);
+  edgeUpMask = ((functions & (1 << FCT_EDGEUP)) != 0)? (edgeUpMask | lanes): (edgeUpMask & ~lanes);
+  registerMask = ((functions & (1 << FCT_REGISTER)) != 0)? (registerMask | lanes): (registerMask & ~lanes);
+  toggleMask = ((functions & (1 << FCT_TOGGLE)) != 0)? (toggleMask | lanes): (toggleMask & ~lanes);
+  startValues &= lanes;
+  lastInputs = (lastInputs & ~lanes) | startValues;
+  registers = (registers & ~lanes) | (startValues & registerMask);
+  toggles = (toggles & ~lanes) | (startValues & toggleMask);
+  isStable = false;
+}
+
+// Signaler uden en funktion går uændret igennem den
+unsigned long t_WordFunctions::dataOut(unsigned long inputs) {
+  unsigned long x = inputs ^ negateMask;
+  unsigned long edges = (edgeUpMask & x & ~lastInputs) | (~edgeUpMask & ~x & lastInputs);
+  lastInputs = x;
+  x = (x & ~edgeMask) | (edges & edgeMask);
+  registers |= x & registerMask;
+  x = (x & ~registerMask) | registers;
+  isStable = ((edges & edgeMask) == 0) && ((x & toggleMask) == 0);
+  toggles ^= x & toggleMask;
+  x = (x & ~toggleMask) | toggles;
+  value = x;
+  return value;
+}
+
 #endif
@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Input driver
- * Version: 1.0
+ * Version: 1.9
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 19-02-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of Input driver.
  * 
@@ -23,6 +23,15 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.1: Timer til filter for kontaktprel tælles af tidshjulet. Standardværdi for argument er fjernet fra definition af metode read.
+ * Version 1.2: Samling af porte der læser Arduinos port registre en gang per cyklus.
+ * Version 1.3: Filter for kontaktprel med lodrette tællere, der behandler 8, 16 eller 32 indgange på en gang.
+ * Version 1.4: Drivere udgiver et øjebliksbillede af portene og hvilke porte der har skiftet siden forrige cyklus.
+ * Version 1.5: Konfigurerede porte holdes med 1 bit per port.
+ * Version 1.6: Filter med lodrette tællere er skilt ud i t_VerticalFilter, så andre drivere kan bruge det.
+ * Version 1.7: Advarsler fra compileren er rettet.
+ * Version 1.8: Advarsel om ubrugt parameter i t_VerticalInDrv er rettet.
+ * Version 1.9: En driver der ikke udgiver, melder alle porte som skiftet.
  */
 
 #ifndef JBInputDriver_h
@@ -39,13 +48,36 @@ enum {INTERN_PULLUP, EXTERN_PULLUP};
 enum {BOUNCE_FILTER, NO_BOUNCE_FILTER};
 
 // Ansvar: Er grænseflade til input porte. Al software der skal bruge input-porte skal koble til grænsefladen.
+// Driveren udgiver i hver cyklus et øjebliksbillede af portene med en bit per port, og hvilke porte der har skiftet siden forrige cyklus.
+// Alle komponenter ser dermed de samme værdier i en cyklus, og komponenter kan springe porte uden skift over.
+// Skift gælder kun fra forrige til denne cyklus. En komponent der springer porte over, skal derfor køre hver gang driveren kører.
+// En driver der ikke udgiver, melder alle porte som skiftet, så komponenter aldrig springer dens porte over.
+// MaxSnapshotPorts: Antal porte i øjebliksbilledet. Porte herover meldes altid som skiftet.
+// inputBits: Værdi af digitale porte i denne cyklus. Bit nr. portNo. Analoge drivere bruger den ikke.
+// changedBits: Porte der har skiftet værdi siden forrige cyklus.
+// isPublishing: Om driveren udgiver skift. Bliver sat første gang driveren udgiver.
+// publish(...): Udgiver nyt øjebliksbillede. Kaldes af doClockCycle.
+// publishChanges(...): Udgiver kun hvilke porte der har skiftet. Bruges af drivere uden øjebliksbillede.
 // doClockCycle(...): Læser input i hvert klokkecyklus.
 // read(...): Indlæser værdi. Pointer til value giver grænseflade til analoge porte.
+// snapshot(...): Leverer øjebliksbilledet.
+// changes(...): Leverer hvilke porte der har skiftet siden forrige cyklus.
+// hasChanged(...): Leverer om en port har skiftet siden forrige cyklus.
 class t_InputDriver {
+protected:
+  unsigned long inputBits;
+  unsigned long changedBits;
+  bool isPublishing;
+  void publish(unsigned long nextInputBits) {publishChanges(inputBits ^ nextInputBits); inputBits = nextInputBits;}
+  void publishChanges(unsigned long changedBits) {this->changedBits = changedBits; isPublishing = true;}
 public:
-  t_InputDriver(void){} 
+  enum {MaxSnapshotPorts=32};
+  t_InputDriver(void): inputBits(0), changedBits(0), isPublishing(false) {}
   virtual void doClockCycle()=0;
   virtual bool read(unsigned int portNo, int *value=nullptr)=0;
+  unsigned long snapshot(void) const {return inputBits;}
+  unsigned long changes(void) const {return (isPublishing == true)? changedBits: 0xFFFFFFFF;}
+  bool hasChanged(unsigned int portNo) const {return (isPublishing == false) || (portNo >= MaxSnapshotPorts) || (((changedBits >> portNo) & 1) != 0);}
 };
 
 //----------
@@ -56,11 +88,12 @@ public:
 // defaultValue: Porten værdi, når den er passiv. Bruges til filter for kontaktprel.
 // Seqs: Porten sekvens når den føres igennem filter for kontaktprel.
 // seq: Porten sekvens når den føres igennem filter for kontaktprel.
-// bounceWait: Timer til filter for kontaktprel.
+// bounceWait: Timer til filter for kontaktprel. Tælles af tidshjulet.
 // bounceTimeClose: Ventetid når en kontakt lukkes og slutter strøm.
 // bounceTimeOpen: Ventetid når en kontakt åbnes og bryder strømmen.
 // setPort(...): Opkobler Arduino og konfigurerer indgangen. En variant kan også sætte tider for kontaktprel.
 // doClockCycle(...): Læser input. Udfører filter for kontaktprel hvis det skal bruges.
+// filter(...): Modtager indlæst værdi og udfører filter for kontaktprel hvis det skal bruges.
 // read(...): Leverer driverens nuværende værdi.
 class t_DigitalParrInPort {
 private:
@@ -69,37 +102,145 @@ private:
   bool defaultValue;
   enum Seqs {STABLE, BOUNCE, NO_BOUNCE};
   Seqs seq;
-  t_SimpleTimer bounceWait;
+  t_WheelTimer bounceWait;
   unsigned int bounceTimeOpen;  
   unsigned int bounceTimeClose;
 public:
   t_DigitalParrInPort(void): bounceTimeOpen(100), bounceTimeClose(30) {}
   void setPort(byte pin, byte ContacType, byte PullupType, byte BounceType);
   void setPort(byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
-  void doClockCycle();
-  bool read(int *value=nullptr) const {return this->value;}
+  void doClockCycle() {filter(digitalRead(pin));}
+  void filter(bool nextValue);
+  bool read(int * /*value*/=nullptr) const {return value;}
 };
 
 //----------
 
 // Ansvar: Holder styr på en samling af parallelle digitale input porte.
 // ports: Vektor med parallelle digitale input porte.
-// isSetup: Vektor der holder styr på om port er konfigureret.
+// isSetup: Holder styr på hvilke porte der er konfigureret. Gennemløb koster efter antal porte i brug.
 // setPort(...): Mapper portNo, opkobler Arduino og konfigurerer indgangen. En variant kan også sætte tider for kontaktprel.
 // doClockCycle(...): Læser input. Udfører filter for kontaktprel hvis det skal bruges.
 // read(...): Leverer driverens nuværende værdi.
 class t_DigitalParrInDrv: public t_InputDriver {
-private:
+protected:
   t_DigitalParrInPort ports[MaxNoInParrPorts];
-  bool isSetup[MaxNoInParrPorts];
+  t_PortSet<MaxNoInParrPorts> isSetup;
 public:
-  t_DigitalParrInDrv(void){for (int cnt=0; cnt < MaxNoInParrPorts; cnt++) isSetup[cnt] = false;}
+  t_DigitalParrInDrv(void){}
   void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType);
   void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
   void doClockCycle();
   bool read(unsigned int portNo, int *value=nullptr);
 };
 
+//----------
+
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+// Drivere der læser port registre, holder en vektor med de registre der er i brug.
+// Returnerer: Indeks i vektoren for registret med pin. Registret tilføjes hvis det ikke er i brug.
+byte mapPortRegister(volatile uint8_t *inRegs[], byte *noInRegs, byte pin);
+
+// Ansvar: Samling af parallelle digitale input porte, der læser Arduinos port registre i stedet for at kalde digitalRead per port.
+// Hvert port register (PINB, PINC, PIND osv.) læses en gang per cyklus, og bits fordeles til portene efter en tabel,
+// der laves når porten sættes op. Det sparer opslag fra pin til port, tjek af timer og beregning af bitmaske for hver port.
+// inRegs: Vektor med de port registre, der er i brug.
+// noInRegs: Antal port registre i brug.
+// regNo: Hvilket port register hver port læses fra.
+// bitMask: Portens bit i registret.
+// setPort(...): Som samlingen af parallelle porte. Tabel til fordeling af bits opdateres.
+// doClockCycle(...): Læser port registre og udfører filter for kontaktprel.
+class t_DigitalPortRegInDrv: public t_DigitalParrInDrv {
+private:
+  volatile uint8_t *inRegs[MaxNoInParrPorts];
+  byte noInRegs;
+  byte regNo[MaxNoInParrPorts];
+  byte bitMask[MaxNoInParrPorts];
+  void mapPin(unsigned int portNo, byte pin);
+public:
+  t_DigitalPortRegInDrv(void): noInRegs(0) {}
+  void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType);
+  void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
+  void doClockCycle();
+};
+#endif
+
+//----------
+
+// Ansvar: Filter for kontaktprel der behandler 8, 16 eller 32 indgange på en gang i et maskinord.
+// Hver indgang er en bit i ordet. Tælleren for hver indgang er lodret, dvs. tællerens bit nr. k for alle indgange
+// ligger i samme ord. En cyklus koster derfor det samme antal instruktioner uanset antal indgange.
+// En indgang skifter værdi, når den indlæste værdi har været forskellig fra nuværende værdi i hele ventetiden.
+// Ventetid ved åbning og lukning af kontakt er separat for hver indgang, som i samlingen af parallelle porte.
+// Filteret bruges af drivere, der indlæser deres indgange som et maskinord.
+// T: Type af maskinord. byte, word eller unsigned long.
+// NoInputs: Antal indgange, en per bit i ordet.
+// NoCounterBits: Antal bit i tælleren. Længste ventetid er 63 cyklus.
+// isSetup: Bitmaske over konfigurerede indgange.
+// value: Indgangenes nuværende værdi.
+// defaultValue: Indgangenes værdi, når de er passive.
+// count: Lodrette tællere.
+// countClose, countOpen: Lodret antal cyklus for ventetid ved lukning og åbning af kontakt.
+// setCount(...): Skriver ventetid lodret i en indgangs bit.
+// setInput(...): Konfigurerer en indgang med kontakttype, filter for kontaktprel og værdi ved start.
+// filter(...): Modtager indlæste værdier og udfører filter for kontaktprel. Returnerer indgangenes nye værdi.
+// dataOut(...): Leverer alle indgange på en gang.
+// configured(...): Leverer bitmasken over konfigurerede indgange.
+template <typename T>
+class t_VerticalFilter {
+private:
+  enum {NoInputs=sizeof(T)*8, NoCounterBits=6};
+  T isSetup;
+  T value;
+  T defaultValue;
+  T count[NoCounterBits];
+  T countClose[NoCounterBits];
+  T countOpen[NoCounterBits];
+  void setCount(T counter[], byte inputNo, unsigned int bounceTime);
+public:
+  t_VerticalFilter(void);
+  void setInput(byte inputNo, byte ContacType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose, bool initialValue);
+  T filter(T nextValue);
+  T dataOut(void) const {return value;}
+  T configured(void) const {return isSetup;}
+};
+
+//----------
+
+// Ansvar: Samling af 8, 16 eller 32 digitale input porte med filter for kontaktprel med lodrette tællere.
+// T: Type af maskinord. byte, word eller unsigned long.
+// NoPorts: Antal indgange, en per bit i ordet.
+// NoPortRegs: Største antal port registre. Arduino Mega har 11 porte med digitale pins.
+// pins: Pin for hver indgang.
+// inputs: Filter for kontaktprel for alle indgange.
+// inRegs, noInRegs, regNo, bitMask: Port registre i brug og hvor hver indgang læses.
+// sample(...): Indlæser alle konfigurerede indgange som et maskinord.
+// setPort(...): Opkobler Arduino og konfigurerer indgangen. En variant kan også sætte tider for kontaktprel.
+// doClockCycle(...): Læser alle indgange og udfører filter for kontaktprel.
+// read(...): Leverer indgangens nuværende værdi.
+// dataOut(...): Leverer alle indgange på en gang.
+template <typename T>
+class t_VerticalInDrv: public t_InputDriver {
+private:
+  enum {NoPorts=sizeof(T)*8, NoPortRegs=(NoPorts < 11)? NoPorts: 11};
+  byte pins[NoPorts];
+  t_VerticalFilter<T> inputs;
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+  volatile uint8_t *inRegs[NoPortRegs];
+  byte noInRegs;
+  byte regNo[NoPorts];
+  byte bitMask[NoPorts];
+#endif
+  T sample(void);
+public:
+  t_VerticalInDrv(void);
+  void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType);
+  void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
+  void doClockCycle() {publish(inputs.filter(sample()));}
+  bool read(unsigned int portNo, int *value=nullptr);
+  T dataOut(void) const {return inputs.dataOut();}
+};
+
 /*
  * CPP kode herunder
  */
@@ -121,15 +262,13 @@ void t_DigitalParrInPort::setPort(byte pin, byte ContacType, byte PullupType, by
   this->bounceTimeClose=bounceTimeClose;
 }
 
-void t_DigitalParrInPort::doClockCycle() {
-  bool nextValue;
+void t_DigitalParrInPort::filter(bool nextValue) {
   unsigned int bounceTime;
-  nextValue = digitalRead(pin);
   switch (seq) {
     case STABLE:
       if (value != nextValue) {
         bounceTime = (defaultValue == value)? bounceTimeClose: bounceTimeOpen;
-        bounceWait.setDuration(bounceTime);
+        bounceWait.start(bounceTime);
         seq = BOUNCE;
       }  
     break;
@@ -152,28 +291,190 @@ void t_DigitalParrInPort::doClockCycle() {
 void t_DigitalParrInDrv::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType) {
   if (isValidIndex(portNo, MaxNoInParrPorts)==true) {
     ports[portNo].setPort(pin, ContacType, PullupType, BounceType);
-    isSetup[portNo] = true;  
+    isSetup.add(portNo);
   } 
 }
   
 void t_DigitalParrInDrv::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose) {
   if (isValidIndex(portNo, MaxNoInParrPorts)==true) {
     ports[portNo].setPort(pin, ContacType, PullupType, BounceType, bounceTimeOpen, bounceTimeClose);  
-    isSetup[portNo] = true;  
+    isSetup.add(portNo);
   }
 }
 
 void t_DigitalParrInDrv::doClockCycle() {
+  unsigned long nextInputBits = 0;
   unsigned int portNo;
-  for (portNo=0; portNo < MaxNoInParrPorts; portNo++) {
-    if (isSetup[portNo] == true) ports[portNo].doClockCycle();
+  for (portNo=isSetup.next(0); portNo < MaxNoInParrPorts; portNo=isSetup.next(portNo+1)) {
+    ports[portNo].doClockCycle();
+    if ((ports[portNo].read() == HIGH) && (portNo < MaxSnapshotPorts)) nextInputBits |= 1UL << portNo;
   }
+  publish(nextInputBits);
 }
   
-bool t_DigitalParrInDrv::read(unsigned int portNo, int *value=nullptr) {
+bool t_DigitalParrInDrv::read(unsigned int portNo, int * /*value*/) {
   bool result = LOW;
   if (hasConfig(isSetup, portNo, MaxNoInParrPorts)==true) result = ports[portNo].read();
   return result;
 }
 
+//----------
+
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+// Samling af parallelle digitale input porte med læsning af port registre
+
+byte mapPortRegister(volatile uint8_t *inRegs[], byte *noInRegs, byte pin) {
+  volatile uint8_t *inReg = portInputRegister(digitalPinToPort(pin));
+  byte cnt;
+  for (cnt=0; (cnt < *noInRegs) && (inRegs[cnt] != inReg); cnt++);
+  if (cnt == *noInRegs) inRegs[(*noInRegs)++] = inReg;
+  return cnt;
+}
+
+void t_DigitalPortRegInDrv::mapPin(unsigned int portNo, byte pin) {
+  regNo[portNo] = mapPortRegister(inRegs, &noInRegs, pin);
+  bitMask[portNo] = digitalPinToBitMask(pin);
+}
+
+void t_DigitalPortRegInDrv::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType) {
+  if (isValidIndex(portNo, MaxNoInParrPorts)==true) {
+    t_DigitalParrInDrv::setPort(portNo, pin, ContacType, PullupType, BounceType);
+    mapPin(portNo, pin);
+  }
+}
+
+void t_DigitalPortRegInDrv::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose) {
+  if (isValidIndex(portNo, MaxNoInParrPorts)==true) {
+    t_DigitalParrInDrv::setPort(portNo, pin, ContacType, PullupType, BounceType, bounceTimeOpen, bounceTimeClose);
+    mapPin(portNo, pin);
+  }
+}
+
+void t_DigitalPortRegInDrv::doClockCycle() {
+  byte regValues[MaxNoInParrPorts] = {0};  // Kun registre i brug læses, men compileren kan ikke se det
+  byte cnt;
+  unsigned long nextInputBits = 0;
+  unsigned int portNo;
+  for (cnt=0; cnt < noInRegs; cnt++) regValues[cnt] = *inRegs[cnt];
+  for (portNo=isSetup.next(0); portNo < MaxNoInParrPorts; portNo=isSetup.next(portNo+1)) {
+    ports[portNo].filter((regValues[regNo[portNo]] & bitMask[portNo]) != 0);
+    if ((ports[portNo].read() == HIGH) && (portNo < MaxSnapshotPorts)) nextInputBits |= 1UL << portNo;
+  }
+  publish(nextInputBits);
+}
+#endif
+
+//----------
+
+// Filter for kontaktprel med lodrette tællere
+
+template <typename T>
+t_VerticalFilter<T>::t_VerticalFilter(void): isSetup(0), value(0), defaultValue(0) {
+  for (byte bit=0; bit < NoCounterBits; bit++) count[bit] = countClose[bit] = countOpen[bit] = 0;
+}
+
+// Antal cyklus for ventetiden skrives lodret i indgangens bit
+template <typename T>
+void t_VerticalFilter<T>::setCount(T counter[], byte inputNo, unsigned int bounceTime) {
+  unsigned long noCycles = Clock::convertToClockCycles(bounceTime);
+  if (noCycles >= (1 << NoCounterBits)) noCycles = (1 << NoCounterBits)-1;
+  T mask = (T)1 << inputNo;
+  for (byte bit=0; bit < NoCounterBits; bit++) {
+    if ((noCycles & (1 << bit)) != 0) counter[bit] |= mask;
+    else counter[bit] &= ~mask;
+  }
+}
+
+template <typename T>
+void t_VerticalFilter<T>::setInput(byte inputNo, byte ContacType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose, bool initialValue) {
+  if (isValidIndex(inputNo, NoInputs) == false) return;
+  T mask = (T)1 << inputNo;
+  if (BounceType == NO_BOUNCE_FILTER) bounceTimeOpen = bounceTimeClose = 0;
+  setCount(countOpen, inputNo, bounceTimeOpen);
+  setCount(countClose, inputNo, bounceTimeClose);
+  defaultValue = (ContacType == NCLOSED)? (defaultValue | mask): (defaultValue & ~mask);
+  value = (initialValue == HIGH)? (value | mask): (value & ~mask);
+  for (byte bit=0; bit < NoCounterBits; bit++) count[bit] &= ~mask;
+  isSetup |= mask;
+}
+
+// En indgang der står på sin passive værdi, lukkes ved skift. Ellers åbnes den.
+// Tællere for indgange med skift sammenlignes med ventetiden. Ved lighed skifter indgangen, ellers tælles op.
+// Indgange uden skift eller der netop har skiftet, nulstilles.
+template <typename T>
+T t_VerticalFilter<T>::filter(T nextValue) {
+  T changed = (nextValue ^ value) & isSetup;
+  T closing = ~(value ^ defaultValue);
+  T isDone = changed;
+  T carry;
+  byte bit;
+  for (bit=0; bit < NoCounterBits; bit++) {
+    T limit = (closing & countClose[bit]) | (~closing & countOpen[bit]);
+    isDone &= ~(count[bit] ^ limit);
+  }
+  carry = changed & ~isDone;
+  for (bit=0; bit < NoCounterBits; bit++) {
+    T nextCarry = count[bit] & carry;
+    count[bit] = (count[bit] ^ carry) & changed & ~isDone;
+    carry = nextCarry;
+  }
+  value ^= isDone;
+  return value;
+}
+
+//----------
+
+// Samling af digitale input porte med lodrette tællere
+
+template <typename T>
+t_VerticalInDrv<T>::t_VerticalInDrv(void) {
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+  noInRegs = 0;
+#endif
+}
+
+template <typename T>
+void t_VerticalInDrv<T>::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType) {
+  setPort(portNo, pin, ContacType, PullupType, BounceType, 100, 30);
+}
+
+template <typename T>
+void t_VerticalInDrv<T>::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose) {
+  if (isValidIndex(portNo, NoPorts) == false) return;
+  pins[portNo] = pin;
+  if ((ContacType == NCLOSED) && (PullupType == INTERN_PULLUP)) pinMode(pin, INPUT_PULLUP);
+  else pinMode(pin, INPUT);
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+  regNo[portNo] = mapPortRegister(inRegs, &noInRegs, pin);
+  bitMask[portNo] = digitalPinToBitMask(pin);
+#endif
+  inputs.setInput(portNo, ContacType, BounceType, bounceTimeOpen, bounceTimeClose, digitalRead(pin));
+}
+
+template <typename T>
+T t_VerticalInDrv<T>::sample(void) {
+  T isSetup = inputs.configured();
+  T nextValue = 0;
+  T mask = 1;
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+  byte regValues[NoPortRegs];
+  for (byte cnt=0; cnt < noInRegs; cnt++) regValues[cnt] = *inRegs[cnt];
+  for (byte portNo=0; portNo < NoPorts; portNo++, mask <<= 1) {
+    if (((isSetup & mask) != 0) && ((regValues[regNo[portNo]] & bitMask[portNo]) != 0)) nextValue |= mask;
+  }
+#else
+  for (byte portNo=0; portNo < NoPorts; portNo++, mask <<= 1) {
+    if (((isSetup & mask) != 0) && (digitalRead(pins[portNo]) == HIGH)) nextValue |= mask;
+  }
+#endif
+  return nextValue;
+}
+
+template <typename T>
+bool t_VerticalInDrv<T>::read(unsigned int portNo, int * /*value*/) {
+  bool result = LOW;
+  if (isValidIndex(portNo, NoPorts) == true) result = ((inputs.dataOut() >> portNo) & 1);
+  return result;
+}
+
 #endif
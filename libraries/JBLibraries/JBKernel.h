@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Kerne med tidsstyring, ure og timere
- * Version: 1.1
+ * Version: 1.13
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 05-04-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of Kerne med tidsstyring, ure og timere.
  * 
@@ -23,12 +23,27 @@
  * 
  * Noter:
  * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.2: Ved simulering på PC venter Clock::pendulum ikke, men lader den virtuelle tid springe frem.
+ * Version 1.3: Klokken måler længste gennemløb, tabte taktslag og ledig tid i cyklus.
+ * Version 1.4: Klokken kan lade CPU gå i dvale mellem taktslag i stedet for at vente aktivt.
+ * Version 1.5: Tidshjul med timere, der ikke tælles ned af ejeren i hver cyklus.
+ * Version 1.6: Klokken tæller taktslag.
+ * Version 1.7: Mængde af konfigurerede porte med 1 bit per port og gennemløb der følger antal porte i brug.
+ * Version 1.8: Tid til næste skift i blinker og til udløb af timer i tidshjulet.
+ * Version 1.9: Markering af port kan fjernes fra mængde af porte.
+ * Version 1.10: Længste gennemløb måles fra det faktiske start af cyklus.
+ * Version 1.11: Timer i tidshjulet kan ikke kopieres og tages ud af hjulet, når den nedlægges.
+ * Version 1.12: Advarsler fra compileren er rettet.
+ * Version 1.13: Timer i tidshjulet regner sekunder om til msek uden overløb.
  */
 
 #ifndef JBKernel_h
 #define JBKernel_h
 
 #include <Arduino.h>
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+#include <avr/sleep.h>
+#endif
 
 // Tidsenhed til konvertering
 enum {MSEC, SECONDS};
@@ -43,10 +58,27 @@ enum {BLINK=2};
 // Det er en ventefunktion som sørger for synkronisering med arduino klokken
 // og kompenserer for den tid det tager at gennemløbe programmet.
 // ClockCycle: Sat til msek
+// IdleSleep: Sat til sand går CPU i dvale mellem taktslag. Det sparer strøm ved drift på batteri eller solceller.
+// t_ClockStats: Måling af programmets gennemløb. Kan aflæses mens programmet kører.
+// stats: Målinger siden start eller seneste nulstilling
+// ticks: Fritløbende tæller af taktslag
 // pendulum(...): Leverer takslaget
+// resetStats(...): Nulstiller målinger
+// waitUntil(...): Venter til et tidspunkt i msek og leverer tiden.
 namespace Clock {
   static byte ClockCycle=5;
+  static bool IdleSleep=false;
+  enum {NoSlackBuckets=4};
+  struct t_ClockStats {
+    byte maxBodyTime;             // Længste gennemløb af programmet i msek. Stopper ved 255
+    unsigned int missedCycles;    // Antal tabte taktslag. Timere går tilsvarende langsomt
+    byte slack[NoSlackBuckets];   // Ledig tid i cyklus: Overskredet, 0-1, 2-3 og 4+ msek. Halveres alle når en tæller er fuld
+  };
+  static t_ClockStats stats;
+  static unsigned long ticks=0;
   void pendulum(void);
+  void resetStats(void);
+  unsigned long waitUntil(unsigned long time);
   unsigned long convertToClockCycles(unsigned long a_time);
 }
 
@@ -71,32 +103,123 @@ public:
 
 //----------
 
+class t_WheelTimer;
+
+// Ansvar: Tidshjulet holder styr på alle t_WheelTimer. Det drejes en plads frem i hvert taktslag fra klokken.
+// En timer sættes i den plads, hvor den udløber. Er tiden længere end en omgang, tælles omgange ned, når pladsen passeres.
+// Indsæt, stop og udløb koster det samme uanset antal timere. I hvert taktslag besøges kun timere i en plads.
+// NoSlots: Antal pladser i hjulet. Skal være en potens af 2.
+// slots: Kæde af timere for hver plads
+// current: Pladsen for nuværende taktslag
+// insert(...): Sætter timer i hjulet
+// remove(...): Tager timer ud af hjulet
+// doClockCycle(...): Drejer hjulet. Kaldes af klokken.
+namespace TimingWheel {
+  enum {NoSlots=32};
+  static t_WheelTimer *slots[NoSlots];
+  static byte current=0;
+  void insert(t_WheelTimer *timer, unsigned int noCycles);
+  void remove(t_WheelTimer *timer);
+  void doClockCycle(void);
+}
+
+// Ansvar: Timer i tidshjulet. Timeren tælles ikke ned af ejeren, men bliver markeret af tidshjulet når tiden er udløbet.
+// Timeren kan erstatte t_SimpleTimer. setDuration gentager som t_SimpleTimer, start udløser en gang.
+// next, prev: Kæde af timere i samme plads
+// noCycles: Varighed i antal cyklus
+// rounds: Antal omgange i hjulet før timeren udløber
+// slot: Plads i hjulet
+// isActive: Timeren er sat i hjulet
+// isPeriodic: Timeren sættes i hjulet igen når den udløber
+// isFired: Tiden er udløbet og ejeren har ikke spurgt endnu
+// setDuration(...): Sætter varighed og starter gentagne udløb
+// start(...): Sætter varighed og starter et udløb
+// cancel(...): Stopper timeren
+// triggered(...): Leverer sand en gang for hvert udløb
+// remaining(...): Leverer antal cyklus til timeren udløber. 0 hvis timeren ikke er i hjulet.
+// Timeren sidder i en kæde i hjulet. Den kan derfor ikke kopieres og tages ud af hjulet, når den nedlægges.
+class t_WheelTimer {
+private:
+  t_WheelTimer *next;
+  t_WheelTimer *prev;
+  unsigned int noCycles;
+  unsigned int rounds;
+  byte slot;
+  bool isActive;
+  bool isPeriodic;
+  bool isFired;
+  void run(unsigned int duration, bool inSeconds, bool isPeriodic);
+  friend void TimingWheel::insert(t_WheelTimer *timer, unsigned int noCycles);
+  friend void TimingWheel::remove(t_WheelTimer *timer);
+  friend void TimingWheel::doClockCycle(void);
+public:
+  t_WheelTimer(void): isActive(false), isFired(false) {}
+  t_WheelTimer(unsigned int duration);
+  t_WheelTimer(const t_WheelTimer &)=delete;
+  t_WheelTimer &operator=(const t_WheelTimer &)=delete;
+  ~t_WheelTimer(void) {TimingWheel::remove(this);}
+  void setDuration(unsigned int duration, bool inSeconds = MSEC) {run(duration, inSeconds, true);}
+  void start(unsigned int duration, bool inSeconds = MSEC) {run(duration, inSeconds, false);}
+  void cancel(void);
+  bool triggered(void);
+  unsigned long remaining(void) const;
+};
+
+//----------
+
 // Ansvar: Blinker leverer standard blink.
 // HalfPeriod: Sat til msek
 // triggered(...): Leverer sand når tiden er udløbet
 namespace Blinker {
   static unsigned int HalfPeriod=500;
   static bool value=false;
-  static t_SimpleTimer timer(HalfPeriod);
+  static t_WheelTimer timer(HalfPeriod);
   void doClockCycle(void);
   bool dataOut(void);
 }
 
 // Al brug af blink og multivibrator går igennem en fælles notifikation
 // Returnerer: Multivibrators kurveform
+// Tid til næste skift i kurveformen kan aflæses, så brugere kan vente på skift i stedet for at aflæse i hver cyklus
+// Returnerer: Antal cyklus til næste skift. 0 hvis kurveformen ikke skifter
 #ifndef Multivibrator_h
 bool blinkerNotification(unsigned int blinkerNo);
+unsigned long blinkerNextEdge(unsigned int blinkerNo);
 #endif
 
 //----------
 
+// Ansvar: Holder styr på konfigurerede porte i en samling med 1 bit per port.
+// Gennemløb springer 8 porte uden konfiguration over ad gangen, så prisen følger antallet af porte i brug.
+// NoPorts: Antal porte i samlingen.
+// bits: En bit per port.
+// add(...): Markerer port som konfigureret. Porte uden for samlingen ignoreres.
+// remove(...): Fjerner markering af port. Porte uden for samlingen ignoreres.
+// has(...): Leverer om port er konfigureret. Porte uden for samlingen er ikke konfigureret.
+// next(...): Leverer første konfigurerede port fra og med portNo. Leverer NoPorts, når der ikke er flere.
+template <unsigned int NoPorts>
+class t_PortSet {
+private:
+  byte bits[(NoPorts+7)/8];
+public:
+  t_PortSet(void) {for (unsigned int cnt=0; cnt < sizeof(bits); cnt++) bits[cnt] = 0;}
+  void add(unsigned int portNo) {if (portNo < NoPorts) bits[portNo >> 3] |= 1 << (portNo & 7);}
+  void remove(unsigned int portNo) {if (portNo < NoPorts) bits[portNo >> 3] &= ~(1 << (portNo & 7));}
+  bool has(unsigned int portNo) const {return (portNo < NoPorts) && ((bits[portNo >> 3] & (1 << (portNo & 7))) != 0);}
+  unsigned int next(unsigned int portNo) const;
+};
+
+//----------
+
 // Der er en del samlinger med arrays, hvor argumenter i metodekald skal tjekkes.
-// Det er en forudsætning at samlingen har et bool array, der har data for konfigurerede elementer
+// Det er en forudsætning at samlingen har et bool array eller en t_PortSet, der har data for konfigurerede elementer
 // Returnerer: Om indeks er gyldigt
 // Returnerer: Om element er konfigureret
 
 bool isValidIndex(unsigned int index, unsigned int arrayLength);
 bool hasConfig(bool isSetup[], unsigned int index, unsigned int arrayLength);
+template <unsigned int NoPorts>
+bool hasConfig(const t_PortSet<NoPorts> &isSetup, unsigned int index, unsigned int /*arrayLength*/) {return isSetup.has(index);}
 bool hasConfig(void *element, unsigned int index, unsigned int arrayLength);
 
 /*
@@ -105,10 +228,65 @@ bool hasConfig(void *element, unsigned int index, unsigned int arrayLength);
 
 void Clock::pendulum(void) {
   static unsigned long cycleStart=0;
+  static unsigned long bodyStart=0;
+  static bool isStarted=false;  // Tiden i setup skal ikke med i målinger
   unsigned long w_millis;     // Tiden skrider hvis millis læser flere gange
-  do w_millis = millis();
-  while (w_millis < (cycleStart+ClockCycle));
+  if (isStarted == true) {
+    w_millis = millis();
+    unsigned long bodyTime = w_millis-bodyStart;     // Gennemløbet måles fra det faktiske start
+    unsigned long cycleTime = w_millis-cycleStart;   // Tabte taktslag og ledig tid regnes fra taktslaget
+    byte bucket;
+    if (bodyTime > stats.maxBodyTime) stats.maxBodyTime = (bodyTime > 255)? 255: bodyTime;
+    if (cycleTime >= ClockCycle) {
+      stats.missedCycles += cycleTime/ClockCycle-1;
+      bucket = 0;
+    }
+    else {
+      byte slack = ClockCycle-cycleTime;
+      bucket = (slack < 2)? 1: (slack < 4)? 2: 3;
+    }
+    if (stats.slack[bucket] == 255) {
+      for (byte cnt=0; cnt < NoSlackBuckets; cnt++) stats.slack[cnt] >>= 1;
+    }
+    stats.slack[bucket]++;
+  }
+  isStarted = true;
+  w_millis = waitUntil(cycleStart+ClockCycle);
+  bodyStart = w_millis;
   cycleStart = (w_millis/ClockCycle)*ClockCycle;  // Omregner til eksakt multiplum clockcykles
+  ticks++;
+  TimingWheel::doClockCycle();
+}
+
+// Timer 0 tæller millis op og vækker CPU fra dvale hvert msek. Derfor er præcisionen den samme som ved aktiv venten.
+// Interrupt er slået fra mens tiden tjekkes. Instruktionen efter sei udføres før interrupt, så CPU kan ikke gå i dvale efter opvågning.
+unsigned long Clock::waitUntil(unsigned long time) {
+  unsigned long w_millis;
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+  if (IdleSleep == true) {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    while ((w_millis = millis()) < time) {
+      sleep_enable();
+      sei();
+      sleep_cpu();
+      sleep_disable();
+      cli();
+    }
+    sei();
+    return w_millis;
+  }
+#endif
+#ifdef ARDUINO_HOSTSIM
+  HostSim::idleUntil(time);  // Ved simulering springer tiden frem i stedet for at vente
+#endif
+  do w_millis = millis();
+  while (w_millis < time);
+  return w_millis;
+}
+
+void Clock::resetStats(void) {
+  memset(&stats, 0, sizeof(stats));
 }
 
 unsigned long Clock::convertToClockCycles(unsigned long a_time) {
@@ -134,6 +312,80 @@ bool t_SimpleTimer::triggered(void) {
 
 //----------
 
+// Tidshjul
+
+void TimingWheel::insert(t_WheelTimer *timer, unsigned int noCycles) {
+  if (noCycles == 0) noCycles = 1;
+  timer->slot = (current+noCycles) & (NoSlots-1);
+  timer->rounds = (noCycles-1)/NoSlots;
+  timer->prev = nullptr;
+  timer->next = slots[timer->slot];
+  if (timer->next != nullptr) timer->next->prev = timer;
+  slots[timer->slot] = timer;
+  timer->isActive = true;
+}
+
+void TimingWheel::remove(t_WheelTimer *timer) {
+  if (timer->isActive == false) return;
+  if (timer->prev != nullptr) timer->prev->next = timer->next;
+  else slots[timer->slot] = timer->next;
+  if (timer->next != nullptr) timer->next->prev = timer->prev;
+  timer->isActive = false;
+}
+
+void TimingWheel::doClockCycle(void) {
+  t_WheelTimer *timer;
+  t_WheelTimer *next;
+  current = (current+1) & (NoSlots-1);
+  for (timer = slots[current]; timer != nullptr; timer = next) {
+    next = timer->next;   // Timer kan blive sat i hjulet igen
+    if (timer->rounds > 0) {
+      timer->rounds--;
+      continue;
+    }
+    remove(timer);
+    timer->isFired = true;
+    if (timer->isPeriodic == true) insert(timer, timer->noCycles);
+  }
+}
+
+//----------
+
+// Timer i tidshjulet
+
+t_WheelTimer::t_WheelTimer(unsigned int duration): isActive(false), isFired(false) {
+  setDuration(duration);
+}
+
+// Sekunder regnes om i unsigned long, så varigheder over 65 sek ikke løber over
+void t_WheelTimer::run(unsigned int duration, bool inSeconds, bool isPeriodic) {
+  unsigned long time = (inSeconds==SECONDS)? SecondsToMilliSecs((unsigned long)duration): duration;
+  TimingWheel::remove(this);
+  noCycles = Clock::convertToClockCycles(time);
+  this->isPeriodic = isPeriodic;
+  isFired = false;
+  TimingWheel::insert(this, noCycles);
+}
+
+void t_WheelTimer::cancel(void) {
+  TimingWheel::remove(this);
+  isFired = false;
+}
+
+bool t_WheelTimer::triggered(void) {
+  bool result = isFired;
+  isFired = false;
+  return result;
+}
+
+// Pladsen i nuværende taktslag er en hel omgang væk
+unsigned long t_WheelTimer::remaining(void) const {
+  if (isActive == false) return 0;
+  return ((slot-TimingWheel::current-1) & (TimingWheel::NoSlots-1))+1+(unsigned long)rounds*TimingWheel::NoSlots;
+}
+
+//----------
+
 void Blinker::doClockCycle(void) {
   if (timer.triggered()==true) value = !value;
 }
@@ -144,14 +396,40 @@ bool Blinker::dataOut(void) {
 
 #ifndef Multivibrator_h
 bool blinkerNotification(unsigned int blinkerNo) {
-  return (blinkerNo == MASTERBLINKERNO)?Blinker::dataOut():OFF;
+  return (blinkerNo == MASTERBLINKERNO) && (Blinker::dataOut() == ON);
+}
+
+// Blinker skifter i den cyklus, hvor timeren udløber, når applikationen kalder Blinker::doClockCycle
+unsigned long blinkerNextEdge(unsigned int blinkerNo) {
+  return (blinkerNo == MASTERBLINKERNO)? Blinker::timer.remaining(): 0;
 }
 #endif
 
 //----------
 
+// Konfigurerede porte
+
+template <unsigned int NoPorts>
+unsigned int t_PortSet<NoPorts>::next(unsigned int portNo) const {
+  while (portNo < NoPorts) {
+    byte rest = bits[portNo >> 3] >> (portNo & 7);
+    if (rest == 0) {
+      portNo = (portNo | 7)+1;
+      continue;
+    }
+    while ((rest & 1) == 0) {
+      rest >>= 1;
+      portNo++;
+    }
+    return portNo;
+  }
+  return NoPorts;
+}
+
+//----------
+
 bool isValidIndex(unsigned int index, unsigned int arrayLength) {
-  return (index >= 0 && index < arrayLength);
+  return (index < arrayLength);
 }
 
 bool hasConfig(bool isSetup[], unsigned int index, unsigned int arrayLength) {
@@ -0,0 +1,258 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Logisk netværk
+ * Version: 1.3
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Logisk netværk".
+ *
+ * "Logisk netværk" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Logisk netværk" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Logisk netværk".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Skrivning til indgang før begin ignoreres.
+ * Version 1.2: Advarsler fra compileren er rettet.
+ * Version 1.3: Grænserne for antal knuder og forbindelser kontrolleres, når programmet oversættes.
+ * Applikationen erklærer MaxNoLogicNodes, MaxNoLogicLinks og MaxNoLogicTimers før biblioteket inkluderes.
+ * Der kan højst være 128 knuder og 255 forbindelser i et netværk.
+ */
+
+#ifndef JBLogicNetwork_h
+#define JBLogicNetwork_h
+
+#include <Arduino.h>
+#include <JBKernel.h>
+
+// Knudenumre og indeks for forbindelser er 1 byte. Bit 7 i et knudenummer markerer negeret indgang.
+static_assert(MaxNoLogicNodes <= 128, "JBLogicNetwork: MaxNoLogicNodes må højst være 128");
+static_assert(MaxNoLogicLinks <= 255, "JBLogicNetwork: MaxNoLogicLinks må højst være 255");
+
+// Erklæring af knuder i et logisk netværk
+enum LogicOps {LOGIC_INPUT, LOGIC_AND, LOGIC_OR, LOGIC_XOR, LOGIC_LATCH, LOGIC_TIMER};
+
+// Ansvar: Netværk af logiske knuder med flere indgange, f.eks. betingelser for sikring af en overkørsel.
+// En knude kan kun bruge knuder, der er tilføjet før den. Knuderne ligger derfor i en rækkefølge, hvor en knude
+// altid beregnes efter sine indgange. I hver cyklus beregnes kun knuder efter en indgang, der har skiftet,
+// så prisen følger aktiviteten og ikke størrelsen af netværket.
+// En indgang til en knude kan negeres med negated(...).
+// Latch har indgangene sæt og reset. Reset har forrang, og uden sæt eller reset beholdes værdien.
+// Timer bliver ON, når indgangen har været ON i varigheden. Den bliver OFF med det samme, når indgangen bliver OFF.
+// NoNode: Leveres, når en knude ikke kan tilføjes.
+// NegateBit: Bit i knudenummer for negeret indgang.
+// ops: Knudernes type.
+// params: Timernummer for timer knuder.
+// inputStart: Knudens første indgang i inputs. Indgange for knude n ligger fra inputStart[n] til inputStart[n+1].
+// inputs: Alle knuders indgange i rækkefølge efter knude.
+// fanoutStart: Knudens første efterfølger i fanout. Efterfølgere for knude n ligger fra fanoutStart[n] til fanoutStart[n+1].
+// fanout: Alle knuders efterfølgere i rækkefølge efter knude. Bygges af begin.
+// values: Knudernes værdi.
+// dirty: Knuder der skal beregnes i næste cyklus.
+// noNodes: Antal knuder.
+// isBuilt: Netværket er bygget og kan ikke udvides.
+// timers: Timere til timer knuder. Tælles af tidshjulet.
+// durations: Varighed for hver timer.
+// inSeconds: Timere hvor varigheden er i sekunder.
+// running: Timere der tæller.
+// elapsed: Timere hvor varigheden er gået, og indgangen stadig er ON.
+// timerNodes: Knude for hver timer.
+// noTimers: Antal timere.
+// add(...): Tilføjer en knude med indgange. Leverer knudenummer eller NoNode.
+// mark(...): Markerer knudens efterfølgere til beregning.
+// input(...): Leverer værdi af en indgang med negering.
+// evaluate(...): Beregner knudens værdi.
+// negated(...): Leverer knudenummer for negeret indgang.
+// addInput(...): Tilføjer en indgang, som applikationen skriver til.
+// addGate(...): Tilføjer AND, OR eller XOR med indgange.
+// addLatch(...): Tilføjer latch med sæt og reset.
+// addTimer(...): Tilføjer timer med indgang og varighed.
+// begin(...): Bygger efterfølgere og beregner alle knuder.
+// write(...): Skriver værdi til en indgang. Før begin bruges startværdien fra addInput.
+// status(...): Leverer knudens værdi.
+// doClockCycle(...): Beregner knuder efter indgange og timere, der har skiftet.
+class t_LogicNetwork {
+public:
+  enum {NoNode=0xFF, NegateBit=0x80};
+private:
+  byte ops[MaxNoLogicNodes];
+  byte params[MaxNoLogicNodes];
+  byte inputStart[MaxNoLogicNodes+1];
+  byte inputs[MaxNoLogicLinks];
+  byte fanoutStart[MaxNoLogicNodes+1];
+  byte fanout[MaxNoLogicLinks];
+  t_PortSet<MaxNoLogicNodes> values;
+  t_PortSet<MaxNoLogicNodes> dirty;
+  byte noNodes;
+  bool isBuilt;
+  t_WheelTimer timers[MaxNoLogicTimers];
+  unsigned int durations[MaxNoLogicTimers];
+  t_PortSet<MaxNoLogicTimers> inSeconds;
+  t_PortSet<MaxNoLogicTimers> running;
+  t_PortSet<MaxNoLogicTimers> elapsed;
+  byte timerNodes[MaxNoLogicTimers];
+  byte noTimers;
+  byte add(LogicOps op, const byte nodeInputs[], byte noInputs);
+  void mark(byte nodeNo);
+  bool input(byte link) const {return values.has(inputs[link] & ~NegateBit) ^ ((inputs[link] & NegateBit) != 0);}
+  bool evaluate(byte nodeNo);
+public:
+  t_LogicNetwork(void): noNodes(0), isBuilt(false), noTimers(0) {inputStart[0] = 0;}
+  static byte negated(byte nodeNo) {return nodeNo | NegateBit;}
+  byte addInput(bool startValue=OFF);
+  byte addGate(LogicOps op, const byte nodeInputs[], byte noInputs);
+  byte addLatch(byte setInput, byte resetInput);
+  byte addTimer(byte input, unsigned int duration, bool inSeconds=MSEC);
+  void begin(void);
+  void write(byte nodeNo, bool value);
+  bool status(byte nodeNo) const {return values.has(nodeNo);}
+  void doClockCycle(void);
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// Indgange skal være tilføjet før knuden, så rækkefølgen altid er gyldig
+byte t_LogicNetwork::add(LogicOps op, const byte nodeInputs[], byte noInputs) {
+  if ((isBuilt == true) || (noNodes == MaxNoLogicNodes) || (noNodes == NegateBit)) return NoNode;
+  if (inputStart[noNodes]+noInputs > MaxNoLogicLinks) return NoNode;
+  for (byte cnt=0; cnt < noInputs; cnt++) {
+    if ((nodeInputs[cnt] & ~NegateBit) >= noNodes) return NoNode;
+  }
+  byte link = inputStart[noNodes];
+  for (byte cnt=0; cnt < noInputs; cnt++) inputs[link++] = nodeInputs[cnt];
+  ops[noNodes] = op;
+  inputStart[noNodes+1] = link;
+  return noNodes++;
+}
+
+byte t_LogicNetwork::addInput(bool startValue) {
+  byte nodeNo = add(LOGIC_INPUT, nullptr, 0);
+  if ((nodeNo != NoNode) && (startValue == ON)) values.add(nodeNo);
+  return nodeNo;
+}
+
+byte t_LogicNetwork::addGate(LogicOps op, const byte nodeInputs[], byte noInputs) {
+  if ((op != LOGIC_AND) && (op != LOGIC_OR) && (op != LOGIC_XOR)) return NoNode;
+  return add(op, nodeInputs, noInputs);
+}
+
+byte t_LogicNetwork::addLatch(byte setInput, byte resetInput) {
+  byte nodeInputs[2] = {setInput, resetInput};
+  return add(LOGIC_LATCH, nodeInputs, 2);
+}
+
+byte t_LogicNetwork::addTimer(byte input, unsigned int duration, bool inSeconds) {
+  if (noTimers == MaxNoLogicTimers) return NoNode;
+  byte nodeNo = add(LOGIC_TIMER, &input, 1);
+  if (nodeNo == NoNode) return NoNode;
+  params[nodeNo] = noTimers;
+  timerNodes[noTimers] = nodeNo;
+  durations[noTimers] = duration;
+  if (inSeconds == SECONDS) this->inSeconds.add(noTimers);
+  noTimers++;
+  return nodeNo;
+}
+
+// Efterfølgere tælles for hver knude og lægges i fanout, så de ligger i samme rækkefølge som knuderne
+void t_LogicNetwork::begin(void) {
+  byte nodeNo;
+  byte link;
+  for (nodeNo=0; nodeNo <= noNodes; nodeNo++) fanoutStart[nodeNo] = 0;
+  for (link=0; link < inputStart[noNodes]; link++) fanoutStart[(inputs[link] & ~NegateBit)+1]++;
+  for (nodeNo=0; nodeNo < noNodes; nodeNo++) fanoutStart[nodeNo+1] += fanoutStart[nodeNo];
+  for (nodeNo=0; nodeNo < noNodes; nodeNo++) {
+    for (link=inputStart[nodeNo]; link < inputStart[nodeNo+1]; link++) {
+      byte from = inputs[link] & ~NegateBit;
+      fanout[fanoutStart[from]++] = nodeNo;
+    }
+  }
+  for (nodeNo=noNodes; nodeNo > 0; nodeNo--) fanoutStart[nodeNo] = fanoutStart[nodeNo-1];
+  fanoutStart[0] = 0;
+  for (nodeNo=0; nodeNo < noNodes; nodeNo++) dirty.add(nodeNo);
+  isBuilt = true;
+  doClockCycle();
+}
+
+void t_LogicNetwork::write(byte nodeNo, bool value) {
+  if ((isBuilt == false) || (nodeNo >= noNodes) || (ops[nodeNo] != LOGIC_INPUT) || (values.has(nodeNo) == value)) return;
+  if (value == ON) values.add(nodeNo);
+  else values.remove(nodeNo);
+  mark(nodeNo);
+}
+
+void t_LogicNetwork::mark(byte nodeNo) {
+  for (byte link=fanoutStart[nodeNo]; link < fanoutStart[nodeNo+1]; link++) dirty.add(fanout[link]);
+}
+
+bool t_LogicNetwork::evaluate(byte nodeNo) {
+  byte first = inputStart[nodeNo];
+  bool value;
+  switch (ops[nodeNo]) {
+    case LOGIC_AND:
+      value = ON;
+      for (byte link=first; (link < inputStart[nodeNo+1]) && (value == ON); link++) value = input(link);
+      return value;
+    case LOGIC_OR:
+      value = OFF;
+      for (byte link=first; (link < inputStart[nodeNo+1]) && (value == OFF); link++) value = input(link);
+      return value;
+    case LOGIC_XOR:
+      value = OFF;
+      for (byte link=first; link < inputStart[nodeNo+1]; link++) value ^= input(link);
+      return value;
+    case LOGIC_LATCH:
+      return (input(first+1) == OFF) && ((input(first) == ON) || (values.has(nodeNo) == ON));
+    case LOGIC_TIMER: {
+      byte timerNo = params[nodeNo];
+      if (timerNo >= MaxNoLogicTimers) return OFF;
+      if (input(first) == OFF) {
+        timers[timerNo].cancel();
+        running.remove(timerNo);
+        elapsed.remove(timerNo);
+        return OFF;
+      }
+      if (elapsed.has(timerNo) == true) return ON;
+      if (running.has(timerNo) == false) {
+        timers[timerNo].start(durations[timerNo], inSeconds.has(timerNo));
+        running.add(timerNo);
+      }
+      return OFF;
+    }
+    default: return values.has(nodeNo);
+  }
+}
+
+// Efterfølgere har højere knudenummer og bliver derfor beregnet i samme gennemløb
+void t_LogicNetwork::doClockCycle(void) {
+  if (isBuilt == false) return;
+  for (byte timerNo=running.next(0); timerNo < MaxNoLogicTimers; timerNo=running.next(timerNo+1)) {
+    if (timers[timerNo].triggered() == true) {
+      running.remove(timerNo);
+      elapsed.add(timerNo);
+      dirty.add(timerNodes[timerNo]);
+    }
+  }
+  for (byte nodeNo=dirty.next(0); nodeNo < noNodes; nodeNo=dirty.next(nodeNo+1)) {
+    dirty.remove(nodeNo);
+    bool value = evaluate(nodeNo);
+    if (value == values.has(nodeNo)) continue;
+    if (value == ON) values.add(nodeNo);
+    else values.remove(nodeNo);
+    mark(nodeNo);
+  }
+}
+
+#endif
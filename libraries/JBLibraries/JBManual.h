@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Manuelle betjeninger
- * Version: 1.1
+ * Version: 1.7
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 31-03-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Manuelle betjeninger".
  * 
@@ -23,6 +23,12 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.2: Simpel knap springer cyklus uden skift på porten over.
+ * Version 1.3: Knap oversætter digitale funktioner til en kæde.
+ * Version 1.4: Samling af knapper, der behandler driverens øjebliksbillede på en gang.
+ * Version 1.5: Kæde med tidsfunktioner beregnes som objekter i knap.
+ * Version 1.6: Simpel knap læser porten i hver cyklus igen, så den virker med alle drivere og ved enhver takt.
+ * Version 1.7: Knap oversætter kæden af objekter i første cyklus, så begin på objekterne før da kommer med. Senere begin og reset på objekterne har ingen virkning.
  */
 
 
@@ -58,6 +64,7 @@ public:
 //----------
 
 // Ansvar: I en række applikationer er der behov for en knap, der blot følger om knappen er aktiv eller passiv.
+// Porten læses i hver cyklus, så knappen følger drivere der ikke udgiver skift, og kan køre sjældnere end driveren.
 // doClockCycle(...): Input driver bliver aflæst i hver klokkescyklus.
 class t_SimpleButton: public t_Manual {
 public:
@@ -68,18 +75,51 @@ public:
 //----------
 
 // Ansvar: Knap simulerer de oftest brugte funktioner ved brug af trykknap og omskifter.
-// digitalFunction: Pointer til en digital funktion.
-// setDigitalFunction(...): Kobler digitalfunction til betjening.
+// Digitale funktioner oversættes til en kæde i knappen, så objekterne ikke bruges, mens programmet kører.
+// En kæde der ikke kan oversættes, f.eks. med tidsfunktioner, beregnes som objekter.
+// functions: Kæde af digitale funktioner.
+// source: Kæde af objekter der endnu ikke er oversat.
+// setDigitalFunction(...): Kobler digitalfunction til betjening. En kæde af objekter oversættes i første klokkecyklus med
+//   objekternes værdier da. Derefter har begin og reset på objekterne ingen virkning i en oversat kæde. Brug knappens reset.
 // doClockCycle(...): Input driver bliver aflæst i hver klokkescyklus.
 // reset(...): Resetter digitale funktioner. Status bliver opdateret i næste klokkecyklus.
 class t_Button: public t_Manual {
 private:
-  t_DigitalFunction *digitalFunction;
+  t_FunctionChain functions;
+  t_DigitalFunction *source;
 public:
-  t_Button(void) {}
-  void setDigitalFunction(t_DigitalFunction *digitalFunction) {this->digitalFunction = digitalFunction;}
+  t_Button(void): source(nullptr) {}
+  void setDigitalFunction(t_DigitalFunction *digitalFunction) {functions.clear(); source = digitalFunction;}
+  void setDigitalFunction(const t_FunctionChain &functions) {this->functions = functions; source = nullptr;}
   void doClockCycle();
-  void reset(void);
+  void reset(void) {if (source != nullptr) source->reset(); else functions.reset();}
+};
+
+//----------
+
+// Ansvar: Samling af knapper på porte 0-31 i samme input driver. Driverens øjebliksbillede behandles af digitale
+// funktioner for 32 signaler på en gang, så prisen per cyklus er den samme uanset antal knapper.
+// Uden skift på knappernes porte og med stabile funktioner er resultatet uændret, og beregningen springes over.
+// driver: Pointer til input driver
+// lanes: Porte med knapper
+// functions: Digitale funktioner for alle knapper
+// begin(...): Initialiserer samlingen
+// setButton(...): Konfigurerer knapper på en gruppe af porte. Funktionerne vælges med bits (1 << FCT_...).
+// doClockCycle(...): Behandler øjebliksbilledet i hver klokkescyklus. Kaldes efter input driveren.
+// status(...): Leverer en knaps tilstand
+// reset(...): Resetter digitale funktioner for en gruppe af porte. Status bliver opdateret i næste klokkecyklus.
+class t_ButtonBank {
+private:
+  t_InputDriver *driver;
+  unsigned long lanes;
+  t_WordFunctions functions;
+public:
+  t_ButtonBank(void): driver(nullptr), lanes(0) {}
+  void begin(t_InputDriver *driver) {this->driver = driver;}
+  void setButton(unsigned long ports, byte functions, unsigned long startValues=0);
+  void doClockCycle(void);
+  byte status(unsigned int portNo) const {return (portNo < t_InputDriver::MaxSnapshotPorts) && (((functions.dataOut() >> portNo) & 1) != 0)? ON: OFF;}
+  void reset(unsigned long ports=0xFFFFFFFF) {functions.reset(ports);}
 };
 
 /*
@@ -106,16 +146,30 @@ void t_SimpleButton::doClockCycle() {
 
 // Knap
 
+// Kæden oversættes først nu, så begin på objekterne efter setDigitalFunction kommer med.
 void t_Button::doClockCycle() {
   if (driver == nullptr) return;
-  bool value = driver->read(portNo);
-  if (digitalFunction != nullptr) value = digitalFunction->dataOut(value); 
+  if (source != nullptr) {
+    functions.compile(source);
+    source = nullptr;
+  }
+  bool value = functions.dataOut(driver->read(portNo));
   state = (value == HIGH)? ON: OFF;
 }
 
-void t_Button::reset(void) {
-  if (digitalFunction == nullptr) return;
-  digitalFunction->reset();
+//----------
+
+// Samling af knapper
+
+void t_ButtonBank::setButton(unsigned long ports, byte functions, unsigned long startValues) {
+  lanes |= ports;
+  this->functions.setLanes(ports, functions, startValues);
+}
+
+void t_ButtonBank::doClockCycle(void) {
+  if (driver == nullptr) return;
+  if (((driver->changes() & lanes) == 0) && (functions.stable() == true)) return;
+  functions.dataOut(driver->snapshot());
 }
 
 #endif
@@ -0,0 +1,196 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Port expander driver
+ * Version: 1.1
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Port expander driver".
+ *
+ * "Port expander driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Port expander driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Port expander driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.1: Advarsler fra compileren er rettet.
+ * MCP23017 kobles til Arduinos I2C: SDA til SDA og SCL til SCL. Adressen vælges med A0-A2 og er 0x20-0x27.
+ * INTA kobles til en pin efter eget valg. Udgangen er open drain, så flere kredse kan dele samme pin.
+ * Uden INTA læses kredsen i hver cyklus.
+ * Driveren sætter I2C clock til 400 kHz. Alle kredse på bussen skal kunne klare det.
+ */
+
+#ifndef JBMcp23017Drv_h
+#define JBMcp23017Drv_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <JBKernel.h>
+#include <JBInputDriver.h>
+#include <JBOutputDriver.h>
+
+// Registre i MCP23017 med IOCON.BANK=0. Register for port B ligger lige efter port A.
+enum {MCP_IODIR=0x00, MCP_GPINTEN=0x04, MCP_IOCON=0x0A, MCP_GPPU=0x0C, MCP_GPIO=0x12, MCP_OLAT=0x14};
+
+// Ansvar: Indgange og udgange på en MCP23017 port expander over I2C.
+// Port 0-7 er GPA0-GPA7, port 8-15 er GPB0-GPB7. En port er enten input eller output.
+// GPIOA og GPIOB læses i en transaktion, hvor kredsen selv tæller registeradressen op.
+// Med INTA koblet til Arduino læses kredsen kun, når en indgang har skiftet. Læsningen nulstiller INTA.
+// Skrivninger ændrer et billede af udgangene i RAM. Kun ændrede registre skrives, og højst en gang per cyklus.
+// NoPorts: Antal porte på kredsen.
+// NoIntPin: Angiver at INTA ikke er koblet til Arduino.
+// I2cClock: Clock for I2C. MCP23017 kan klare 1,7 MHz. Arduino Uno giver højst 400 kHz.
+// IoCon: Konfiguration af kredsen. INTA og INTB spejles og er open drain. Registeradressen tælles op.
+// address: Kredsens adresse på bussen.
+// intPin: Pin til INTA.
+// direction: IODIR. 1 for input, 0 for output.
+// pullups: GPPU. 1 for intern pullup.
+// gpio: Seneste læste værdi af GPIOA og GPIOB.
+// image: Billede af udgangene.
+// written: Udgange som de senest er skrevet til kredsen.
+// inputs: Filter for kontaktprel.
+// writeRegs(...): Skriver et par af registre for port A og B.
+// readGpio(...): Læser GPIOA og GPIOB.
+// writeOutputs(...): Skriver ændrede udgange til kredsen.
+// begin(...): Opkobler Arduino og konfigurerer kredsen med alle porte som input.
+// setInPort(...): Konfigurerer en port som input. En variant kan også sætte tider for kontaktprel.
+// setOutPort(...): Konfigurerer en port som output.
+// doClockCycle(...): Skriver ændrede udgange, læser kredsen hvis en indgang har skiftet og udfører filter for kontaktprel.
+// read(...): Leverer indgangens nuværende værdi.
+// write(...): Skriver værdi i billedet af udgangene.
+class t_Mcp23017Drv: public t_InputDriver, public t_OutputDriver {
+private:
+  enum {NoPorts=16, NoIntPin=0xFF, IoCon=0x44};
+  static const uint32_t I2cClock = 400000;
+  byte address;
+  byte intPin;
+  uint16_t direction;
+  uint16_t pullups;
+  uint16_t gpio;
+  uint16_t image;
+  uint16_t written;
+  t_VerticalFilter<uint16_t> inputs;
+  void writeRegs(byte reg, uint16_t value);
+  bool readGpio(void);
+  void writeOutputs(void);
+public:
+  t_Mcp23017Drv(void): intPin(NoIntPin), direction(0xFFFF), pullups(0), gpio(0), image(0), written(0) {}
+  void begin(byte address, byte intPin=NoIntPin);
+  void setInPort(unsigned int portNo, byte ContacType, byte PullupType, byte BounceType);
+  void setInPort(unsigned int portNo, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
+  void setOutPort(unsigned int portNo, bool value=LOW);
+  void doClockCycle(void);
+  bool read(unsigned int portNo, int *value=nullptr);
+  void write(unsigned int portNo, bool value);
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// MCP23017 port expander
+
+void t_Mcp23017Drv::begin(byte address, byte intPin) {
+  this->address = address;
+  this->intPin = intPin;
+  Wire.begin();
+  Wire.setClock(I2cClock);
+  Wire.beginTransmission(address);
+  Wire.write(MCP_IOCON);
+  Wire.write(IoCon);
+  Wire.endTransmission();
+  writeRegs(MCP_IODIR, direction);
+  writeRegs(MCP_GPPU, pullups);
+  writeRegs(MCP_GPINTEN, 0);
+  if (intPin != NoIntPin) pinMode(intPin, INPUT_PULLUP);
+  readGpio();
+}
+
+void t_Mcp23017Drv::writeRegs(byte reg, uint16_t value) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  Wire.write(lowByte(value));
+  Wire.write(highByte(value));
+  Wire.endTransmission();
+}
+
+// Registeradressen sættes uden stop, så begge registre læses i samme transaktion.
+// Ved fejl på bussen beholdes den seneste værdi.
+bool t_Mcp23017Drv::readGpio(void) {
+  Wire.beginTransmission(address);
+  Wire.write(MCP_GPIO);
+  if (Wire.endTransmission(false) != 0) return false;
+  if (Wire.requestFrom(address, (uint8_t)2) != 2) return false;
+  byte gpioA = Wire.read();
+  gpio = word(Wire.read(), gpioA);
+  return true;
+}
+
+void t_Mcp23017Drv::setInPort(unsigned int portNo, byte ContacType, byte PullupType, byte BounceType) {
+  setInPort(portNo, ContacType, PullupType, BounceType, 100, 30);
+}
+
+void t_Mcp23017Drv::setInPort(unsigned int portNo, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose) {
+  if (isValidIndex(portNo, NoPorts) == false) return;
+  uint16_t mask = (uint16_t)1 << portNo;
+  direction |= mask;
+  if ((ContacType == NCLOSED) && (PullupType == INTERN_PULLUP)) pullups |= mask;
+  else pullups &= ~mask;
+  writeRegs(MCP_IODIR, direction);
+  writeRegs(MCP_GPPU, pullups);
+  writeRegs(MCP_GPINTEN, inputs.configured() | mask);
+  readGpio();
+  inputs.setInput(portNo, ContacType, BounceType, bounceTimeOpen, bounceTimeClose, (gpio & mask) != 0);
+}
+
+void t_Mcp23017Drv::setOutPort(unsigned int portNo, bool value) {
+  if (isValidIndex(portNo, NoPorts) == false) return;
+  uint16_t mask = (uint16_t)1 << portNo;
+  image = (value == LOW)? (image & ~mask): (image | mask);
+  writeRegs(MCP_OLAT, image);
+  written = image;
+  direction &= ~mask;
+  writeRegs(MCP_IODIR, direction);
+}
+
+void t_Mcp23017Drv::write(unsigned int portNo, bool value) {
+  if (isValidIndex(portNo, NoPorts) == false) return;
+  uint16_t mask = (uint16_t)1 << portNo;
+  image = (value == LOW)? (image & ~mask): (image | mask);
+}
+
+// Er kun det ene register ændret, skrives kun det. Ved fejl på bussen forsøges igen i næste cyklus.
+void t_Mcp23017Drv::writeOutputs(void) {
+  uint16_t changed = image ^ written;
+  Wire.beginTransmission(address);
+  Wire.write(((changed & 0x00FF) != 0)? MCP_OLAT: MCP_OLAT+1);
+  if ((changed & 0x00FF) != 0) Wire.write(lowByte(image));
+  if ((changed & 0xFF00) != 0) Wire.write(highByte(image));
+  if (Wire.endTransmission() == 0) written = image;
+}
+
+// Uden skift på indgangene filtreres den seneste læste værdi igen, så filteret for kontaktprel kan tælle færdigt.
+void t_Mcp23017Drv::doClockCycle(void) {
+  if (image != written) writeOutputs();
+  if (inputs.configured() == 0) return;
+  if ((intPin == NoIntPin) || (digitalRead(intPin) == LOW)) readGpio();
+  publish(inputs.filter(gpio));
+}
+
+bool t_Mcp23017Drv::read(unsigned int portNo, int * /*value*/) {
+  bool result = LOW;
+  if (isValidIndex(portNo, NoPorts) == true) result = (inputs.dataOut() >> portNo) & 1;
+  return result;
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Multivibrator
+ * Version: 1.3
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Multivibrator".
+ * 
+ * "Multivibrator" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Multivibrator" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Multivibrator".  If not, see <https://www.gnu.org/licenses/>.
+ *  
+ * Noter: 
+ * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Tid til næste skift i en kanal.
+ * Version 1.2: Kanalens periode holdes præcist i antal taktslag.
+ * Version 1.3: Advarsler fra compileren er rettet.
+ * Applikationen erklærer MaxNoBlinkers og inkluderer biblioteket før JBKernel.h.
+ */
+
+#ifndef Multivibrator_h
+#define Multivibrator_h
+
+#ifdef JBKernel_h
+#error "JBMultivibrator.h skal inkluderes før JBKernel.h"
+#endif
+
+#include <Arduino.h>
+#include <JBKernel.h>
+
+// Ansvar: Multivibrator leverer mange blinkmønstre med hver sin periode, pulsbredde og faseforskydning.
+// Alle kanaler beregnes ud fra klokkens fritløbende tæller af taktslag. Der er ingen timer per kanal,
+// og prisen per cyklus vokser ikke med antal kanaler. En kanal beregnes kun, når den aflæses.
+// Kanalens position i perioden er resten af tælleren divideret med periodens antal taktslag, så perioden holdes præcist.
+// Alle kanaler bruger samme tæller og holder derfor deres indbyrdes fase. Når tælleren løber rundt efter 2^32 taktslag,
+// bliver en periode afkortet en gang.
+// t_Channel: Periode, faseforskydning og længde af ON i antal taktslag.
+// MasterChannel: Standard blink med 500 msek ON og 500 msek OFF på MASTERBLINKERNO.
+// channels: Vektor med kanaler
+// configure(...): Beregner kanal ud fra periode i msek, pulsbredde i procent og faseforskydning i msek
+// setChannel(...): Konfigurerer kanal
+// dataOut(...): Leverer kanalens kurveform
+// nextEdge(...): Leverer antal taktslag til kanalens næste skift. 0 hvis kanalen ikke skifter.
+namespace Multivibrator {
+  struct t_Channel {
+    word noCycles;
+    word phase;
+    word onLength;
+  };
+  static t_Channel MasterChannel;
+  static t_Channel channels[MaxNoBlinkers];
+  void configure(t_Channel *channel, unsigned int period, byte dutyCycle, unsigned int phaseShift);
+  void setChannel(unsigned int blinkerNo, unsigned int period, byte dutyCycle=50, unsigned int phaseShift=0);
+  bool dataOut(const t_Channel *channel);
+  unsigned long nextEdge(const t_Channel *channel);
+}
+
+// Al brug af blink og multivibrator går igennem en fælles notifikation
+// Returnerer: Multivibrators kurveform
+// Tid til næste skift i kurveformen kan aflæses, så brugere kan vente på skift i stedet for at aflæse i hver cyklus
+// Returnerer: Antal cyklus til næste skift. 0 hvis kurveformen ikke skifter
+bool blinkerNotification(unsigned int blinkerNo);
+unsigned long blinkerNextEdge(unsigned int blinkerNo);
+
+/*
+ * CPP kode herunder
+ */
+
+void Multivibrator::configure(t_Channel *channel, unsigned int period, byte dutyCycle, unsigned int phaseShift) {
+  unsigned long noCycles = Clock::convertToClockCycles(period);
+  if (noCycles == 0) noCycles = 1;
+  if (dutyCycle > 100) dutyCycle = 100;
+  channel->noCycles = noCycles;
+  channel->phase = Clock::convertToClockCycles(phaseShift) % noCycles;
+  channel->onLength = (unsigned long)dutyCycle*noCycles/100;
+}
+
+void Multivibrator::setChannel(unsigned int blinkerNo, unsigned int period, byte dutyCycle, unsigned int phaseShift) {
+  if (isValidIndex(blinkerNo, MaxNoBlinkers) == true) configure(&channels[blinkerNo], period, dutyCycle, phaseShift);
+}
+
+bool Multivibrator::dataOut(const t_Channel *channel) {
+  if (channel->noCycles == 0) return OFF;
+  word position = (Clock::ticks+channel->phase) % channel->noCycles;
+  return (position < channel->onLength);
+}
+
+// ON slutter, når positionen når onLength, og OFF slutter, når perioden begynder forfra
+unsigned long Multivibrator::nextEdge(const t_Channel *channel) {
+  if ((channel->noCycles == 0) || (channel->onLength == 0) || (channel->onLength >= channel->noCycles)) return 0;
+  word position = (Clock::ticks+channel->phase) % channel->noCycles;
+  return (position < channel->onLength)? channel->onLength-position: channel->noCycles-position;
+}
+
+bool blinkerNotification(unsigned int blinkerNo) {
+  if (blinkerNo == MASTERBLINKERNO) {
+    if (Multivibrator::MasterChannel.noCycles == 0) Multivibrator::configure(&Multivibrator::MasterChannel, 2*Blinker::HalfPeriod, 50, 0);
+    return Multivibrator::dataOut(&Multivibrator::MasterChannel);
+  }
+  return (isValidIndex(blinkerNo, MaxNoBlinkers) == true) && (Multivibrator::dataOut(&Multivibrator::channels[blinkerNo]) == ON);
+}
+
+unsigned long blinkerNextEdge(unsigned int blinkerNo) {
+  if (blinkerNo == MASTERBLINKERNO) {
+    if (Multivibrator::MasterChannel.noCycles == 0) Multivibrator::configure(&Multivibrator::MasterChannel, 2*Blinker::HalfPeriod, 50, 0);
+    return Multivibrator::nextEdge(&Multivibrator::MasterChannel);
+  }
+  return (isValidIndex(blinkerNo, MaxNoBlinkers) == true)? Multivibrator::nextEdge(&Multivibrator::channels[blinkerNo]): 0;
+}
+
+#endif
@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Output drivere
- * Version: 1.1
+ * Version: 1.4
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 21-04-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of Output drivere.
  * 
@@ -24,6 +24,9 @@
  * Noter:
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
  * Version 1.1: Samling af outputdrivere. Metode setPort satte udgang lav uanset argument i kald. fejlen er rettet og argument respekteres.
+ * Version 1.2: Konfigurerede porte holdes med 1 bit per port. Standardværdi for argument er fjernet fra definition af metode setPort.
+ * Version 1.3: Samling af output porte med skyggeregistre, der udlæses til port registre en gang per cyklus.
+ * Version 1.4: Advarsler fra compileren er rettet.
  */
 
 #ifndef JBOutputDriver_h
@@ -33,12 +36,14 @@
 #include <JBKernel.h>
 
 // Ansvar: Er grænseflade til output porte. Al software der skal bruge output-porte skal koble til grænsefladen.
+// doClockCycle(...): Afslutter cyklus. Drivere der samler skrivninger, udlæser dem her.
 // write(...): Udlæser værdi. Sørger for kun at opdatere arduino port ved behov. Er klar til både digital og analog udlæsning.
 class t_OutputDriver {
 public:
   t_OutputDriver(void){}
-  virtual void write(unsigned int portNo, bool value){}
-  virtual void write(unsigned int portNo, int value){}
+  virtual void doClockCycle(void){}
+  virtual void write(unsigned int /*portNo*/, bool /*value*/){}
+  virtual void write(unsigned int /*portNo*/, int /*value*/){}
 };
 
 // Ansvar: Indeholder data til en digital parallel output port.
@@ -58,19 +63,55 @@ public:
 
 // Ansvar: Holder styr på samling af digitale parallelle output porte.
 // ports: Vektor med output port konfiguration
-// isSetup: Holder styr på om port er initialiseret
+// isSetup: Holder styr på om port er initialiseret. 1 bit per port.
 // setPort(...): Mapper portNo, opkobler Arduino og konfigurerer udgangen.
 // write(...): Skriver værdi til en konkret port.
 class t_DigitalParrOutDrv: public t_OutputDriver {
 private:
   t_DigitalParrOutPort ports[MaxNoOutParrPorts];
-  bool isSetup[MaxNoOutParrPorts];
+  t_PortSet<MaxNoOutParrPorts> isSetup;
 public:
-  t_DigitalParrOutDrv(void){for (int cnt=0; cnt < MaxNoOutParrPorts; cnt++) isSetup[cnt] = false;}
+  t_DigitalParrOutDrv(void){}
   void setPort(unsigned int portNo, byte pin, bool value=LOW);
   void write(unsigned int portNo, bool value);
 };
 
+//----------
+
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+// Ansvar: Samling af digitale parallelle output porte, der skriver i skyggeregistre og udlæser dem til Arduinos port registre en gang per cyklus.
+// En skrivning ændrer kun en bit i skyggeregistret. Udgange på samme port register skifter i samme instruktion,
+// f.eks. de skiftevis blinkende lamper i en jernbaneoverskæring. Udgange på forskellige port registre skifter lige efter hinanden.
+// Bits for pins der ikke tilhører samlingen, røres ikke. De kan f.eks. være pullup for indgange eller styres af en interrupt rutine.
+// MaxNoOutRegs: Største antal port registre. Arduino Mega har 11 porte med digitale pins.
+// outRegs: Vektor med de port registre, der er i brug.
+// shadows: Skyggeregister for hvert port register i brug.
+// ownMasks: De bits i hvert port register, som samlingen styrer.
+// noOutRegs: Antal port registre i brug.
+// regNo: Hvilket port register hver port skrives til.
+// bitMask: Portens bit i registret.
+// isSetup: Holder styr på om port er initialiseret. 1 bit per port.
+// setPort(...): Mapper portNo, opkobler Arduino og konfigurerer udgangen. Udgangen sættes med det samme.
+// write(...): Skriver værdi i skyggeregistret.
+// doClockCycle(...): Udlæser skyggeregistre der er ændret. Kaldes sidst i cyklus.
+class t_DigitalPortRegOutDrv: public t_OutputDriver {
+private:
+  enum {MaxNoOutRegs=(MaxNoOutParrPorts < 11)? MaxNoOutParrPorts: 11};
+  volatile uint8_t *outRegs[MaxNoOutRegs];
+  byte shadows[MaxNoOutRegs];
+  byte ownMasks[MaxNoOutRegs];
+  byte noOutRegs;
+  byte regNo[MaxNoOutParrPorts];
+  byte bitMask[MaxNoOutParrPorts];
+  t_PortSet<MaxNoOutParrPorts> isSetup;
+public:
+  t_DigitalPortRegOutDrv(void): noOutRegs(0) {}
+  void setPort(unsigned int portNo, byte pin, bool value=LOW);
+  void write(unsigned int portNo, bool value);
+  void doClockCycle(void);
+};
+#endif
+
 /*
  * CPP kode herunder
  */
@@ -79,7 +120,7 @@ public:
 
 // Outputport
 
-void t_DigitalParrOutPort::setPort(byte pin, bool value=LOW) {
+void t_DigitalParrOutPort::setPort(byte pin, bool value) {
   this->pin = pin;
   this->value = value;
   pinMode(pin, OUTPUT);
@@ -96,14 +137,56 @@ void t_DigitalParrOutPort::write(bool value) {
 
 // Samlingen af outputporte
 
-void t_DigitalParrOutDrv::setPort(unsigned int portNo, byte pin, bool value=LOW) {
+void t_DigitalParrOutDrv::setPort(unsigned int portNo, byte pin, bool value) {
   if (isValidIndex(portNo, MaxNoOutParrPorts)==true) {
     ports[portNo].setPort(pin, value);
-    isSetup[portNo] = true;
+    isSetup.add(portNo);
   }
 }
 
 void t_DigitalParrOutDrv::write(unsigned int portNo, bool value) {
   if (hasConfig(isSetup, portNo, MaxNoOutParrPorts)==true) ports[portNo].write(value);
 }
+
+//----------
+
+#if defined(__AVR__) || defined(ARDUINO_HOSTSIM)
+// Samling af digitale parallelle output porte med skyggeregistre
+
+void t_DigitalPortRegOutDrv::setPort(unsigned int portNo, byte pin, bool value) {
+  if (isValidIndex(portNo, MaxNoOutParrPorts) == false) return;
+  volatile uint8_t *outReg = portOutputRegister(digitalPinToPort(pin));
+  byte cnt;
+  for (cnt=0; (cnt < noOutRegs) && (outRegs[cnt] != outReg); cnt++);
+  if (cnt == noOutRegs) {
+    if (noOutRegs == MaxNoOutRegs) return;
+    outRegs[noOutRegs++] = outReg;
+    shadows[cnt] = ownMasks[cnt] = 0;
+  }
+  regNo[portNo] = cnt;
+  bitMask[portNo] = digitalPinToBitMask(pin);
+  ownMasks[cnt] |= bitMask[portNo];
+  isSetup.add(portNo);
+  write(portNo, value);
+  digitalWrite(pin, value);
+  pinMode(pin, OUTPUT);
+}
+
+void t_DigitalPortRegOutDrv::write(unsigned int portNo, bool value) {
+  if (hasConfig(isSetup, portNo, MaxNoOutParrPorts) == false) return;
+  if (value == LOW) shadows[regNo[portNo]] &= ~bitMask[portNo];
+  else shadows[regNo[portNo]] |= bitMask[portNo];
+}
+
+// Læs, ret og skriv af port registret sker med interrupt slået fra, så en interrupt rutine der skriver andre bits i samme register ikke overskrives.
+void t_DigitalPortRegOutDrv::doClockCycle(void) {
+  for (byte cnt=0; cnt < noOutRegs; cnt++) {
+    volatile uint8_t *outReg = outRegs[cnt];
+    if (((*outReg ^ shadows[cnt]) & ownMasks[cnt]) == 0) continue;
+    noInterrupts();
+    *outReg = (*outReg & ~ownMasks[cnt]) | shadows[cnt];
+    interrupts();
+  }
+}
+#endif
 #endif
@@ -0,0 +1,291 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Input driver med pin change interrupt
+ * Version: 1.4
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Input driver med pin change interrupt".
+ *
+ * "Input driver med pin change interrupt" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Input driver med pin change interrupt" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Input driver med pin change interrupt".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.1: Udgiver øjebliksbillede og skift.
+ * Version 1.2: Konfigurerede porte holdes med 1 bit per port. Kun aktive porte opdaterer øjebliksbilledet.
+ * Version 1.3: Advarsler fra compileren er rettet.
+ * Version 1.4: Når køen har været fuld, læses port registrene igen, så portene ikke hænger i et forældet niveau.
+ * Applikationen erklærer MaxNoInPCIntPorts før biblioteket inkluderes.
+ * Biblioteket definerer interrupt rutinerne PCINT0_vect, PCINT1_vect og PCINT2_vect. Det kan derfor ikke bruges sammen
+ * med andre biblioteker, der bruger pin change interrupt, f.eks. SoftwareSerial.
+ * En gruppe af pin change interrupt læses fra et port register. På Arduino Mega kan PCINT8 (port E) derfor ikke bruges
+ * sammen med pins fra port J.
+ */
+
+#ifndef JBPinChangeInDrv_h
+#define JBPinChangeInDrv_h
+
+#if !defined(__AVR__) && !defined(ARDUINO_HOSTSIM)
+#error "JBPinChangeInDrv kræver AVR med pin change interrupt"
+#endif
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <JBKernel.h>
+#include <JBInputDriver.h>
+
+// Ansvar: Kø med skift på indgange. Interrupt rutinerne lægger skift i køen, og driveren tømmer den i hver cyklus.
+// Køen har en skriver og en læser. Interrupt rutinen ændrer kun head og driveren ændrer kun tail, og begge er 1 byte.
+// Derfor skal interrupt ikke slås fra, når køen tømmes.
+// NoGroups: Antal grupper af pin change interrupt.
+// QueueSize: Antal pladser i køen. Skal være en potens af 2.
+// t_Event: Et skift. Tid i msek og værdi af gruppens port register lige efter skiftet.
+// groupRegs: Port register for hver gruppe.
+// queue: Ringbuffer med skift.
+// head: Næste plads der skrives i.
+// tail: Næste plads der læses fra.
+// noLost: Antal skift der er tabt, fordi køen var fuld.
+// push(...): Lægger et skift i køen. Kaldes fra interrupt rutine.
+// pop(...): Henter et skift fra køen. Returnerer false hvis køen er tom.
+namespace PinChange {
+  const byte NoGroups = 3;
+  const byte QueueSize = 16;
+  struct t_Event {
+    word time;
+    byte group;
+    byte regValue;
+  };
+  static volatile uint8_t *groupRegs[NoGroups];
+  static volatile t_Event queue[QueueSize];
+  static volatile byte head=0;
+  static volatile byte tail=0;
+  static volatile unsigned int noLost=0;
+  void push(byte group);
+  bool pop(t_Event *event);
+}
+
+//----------
+
+// Ansvar: Samling af digitale input porte, der kun behandles når de skifter.
+// Pin change interrupt giver hvert skift et tidsstempel. Filter for kontaktprel regnes fra tidspunktet for seneste skift,
+// og kun porte med skift der ikke er afklaret, behandles i hver cyklus. Uden filter for kontaktprel fanges pulser,
+// der er kortere end en cyklus. Porten har da aktiv værdi i den følgende cyklus.
+// t_Port: En port.
+//   group, bitMask: Gruppe af pin change interrupt og portens bit i gruppens port register.
+//   defaultValue: Porten værdi, når den er passiv.
+//   isFiltered: Om der bruges filter for kontaktprel.
+//   level: Niveau efter seneste skift.
+//   value: Gemmer den filtrerede værdi til senere brug.
+//   isPulse: Om der er fanget en puls, der endnu ikke er leveret.
+//   lastEdge: Tid i msek for seneste skift.
+//   bounceTimeOpen, bounceTimeClose: Ventetid når en kontakt åbnes og lukkes.
+// ports: Vektor med porte.
+// isSetup: Holder styr på hvilke porte der er konfigureret. Gennemløb koster efter antal porte i brug.
+// active: Porte med skift, der ikke er afklaret.
+// noActive: Antal porte med skift, der ikke er afklaret.
+// lastRegs: Værdi af hver gruppes port register efter seneste skift.
+// lastLost: Antal tabte skift, da køen senest blev tømt.
+// edge(...): Fordeler et skift fra køen til de porte, der har skiftet.
+// resync(...): Læser gruppernes port registre, når skift er tabt, så portene får det niveau, indgangene har nu.
+// settle(...): Udfører filter for kontaktprel. Returnerer true, når porten er afklaret.
+// setPort(...): Opkobler Arduino, konfigurerer indgangen og slår pin change interrupt til. En variant kan også sætte tider for kontaktprel.
+// doClockCycle(...): Tømmer køen og behandler porte med skift.
+// read(...): Leverer driverens nuværende værdi.
+// lostEvents(...): Leverer antal skift der er tabt, fordi køen var fuld.
+class t_PinChangeInDrv: public t_InputDriver {
+private:
+  struct t_Port {
+    byte group;
+    byte bitMask;
+    bool defaultValue;
+    bool isFiltered;
+    bool level;
+    bool value;
+    bool isPulse;
+    word lastEdge;
+    unsigned int bounceTimeOpen;
+    unsigned int bounceTimeClose;
+  };
+  t_Port ports[MaxNoInPCIntPorts];
+  t_PortSet<MaxNoInPCIntPorts> isSetup;
+  byte active[MaxNoInPCIntPorts];
+  byte noActive;
+  byte lastRegs[PinChange::NoGroups];
+  unsigned int lastLost;
+  void edge(const PinChange::t_Event &event);
+  void resync(word now);
+  bool settle(t_Port &port, word now);
+public:
+  t_PinChangeInDrv(void);
+  void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType);
+  void setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
+  void doClockCycle();
+  bool read(unsigned int portNo, int *value=nullptr);
+  unsigned int lostEvents(void) const {return PinChange::noLost;}
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// Kø med skift
+
+void PinChange::push(byte group) {
+  byte next = (head+1) & (QueueSize-1);
+  if (next == tail) {
+    noLost++;
+    return;
+  }
+  queue[head].time = millis();
+  queue[head].group = group;
+  queue[head].regValue = *groupRegs[group];
+  head = next;
+}
+
+bool PinChange::pop(t_Event *event) {
+  if (tail == head) return false;
+  event->time = queue[tail].time;
+  event->group = queue[tail].group;
+  event->regValue = queue[tail].regValue;
+  tail = (tail+1) & (QueueSize-1);
+  return true;
+}
+
+#ifdef PCINT0_vect
+ISR(PCINT0_vect) {PinChange::push(0);}
+#endif
+#ifdef PCINT1_vect
+ISR(PCINT1_vect) {PinChange::push(1);}
+#endif
+#ifdef PCINT2_vect
+ISR(PCINT2_vect) {PinChange::push(2);}
+#endif
+
+//----------
+
+// Samling af digitale input porte med pin change interrupt
+
+t_PinChangeInDrv::t_PinChangeInDrv(void): noActive(0), lastLost(0) {}
+
+void t_PinChangeInDrv::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType) {
+  setPort(portNo, pin, ContacType, PullupType, BounceType, 100, 30);
+}
+
+// Skift der allerede ligger i køen, fordeles før gruppens register læses. Ellers kan et gammelt skift ses som et skift på den nye port.
+// En ny port er aktiv, så dens værdi kommer med i øjebliksbilledet i næste cyklus.
+void t_PinChangeInDrv::setPort(unsigned int portNo, byte pin, byte ContacType, byte PullupType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose) {
+  PinChange::t_Event event;
+  if ((isValidIndex(portNo, MaxNoInPCIntPorts) == false) || (digitalPinToPCICR(pin) == nullptr)) return;
+  t_Port &port = ports[portNo];
+  port.group = digitalPinToPCICRbit(pin);
+  port.bitMask = digitalPinToBitMask(pin);
+  port.defaultValue = (ContacType == NCLOSED);
+  port.isFiltered = (BounceType == BOUNCE_FILTER);
+  port.isPulse = false;
+  port.bounceTimeOpen = bounceTimeOpen;
+  port.bounceTimeClose = bounceTimeClose;
+  if ((ContacType == NCLOSED) && (PullupType == INTERN_PULLUP)) pinMode(pin, INPUT_PULLUP);
+  else pinMode(pin, INPUT);
+  while (PinChange::pop(&event) == true) edge(event);
+  noInterrupts();
+  PinChange::groupRegs[port.group] = portInputRegister(digitalPinToPort(pin));
+  lastRegs[port.group] = *PinChange::groupRegs[port.group];
+  port.level = port.value = ((lastRegs[port.group] & port.bitMask) != 0);
+  *digitalPinToPCMSK(pin) |= 1 << digitalPinToPCMSKbit(pin);
+  *digitalPinToPCICR(pin) |= 1 << port.group;
+  interrupts();
+  if (isSetup.has(portNo) == false) active[noActive++] = portNo;
+  isSetup.add(portNo);
+}
+
+// Skiftet sammenlignes med gruppens forrige værdi. Porte hvis bit har skiftet, får nyt niveau og tidsstempel og bliver aktive.
+void t_PinChangeInDrv::edge(const PinChange::t_Event &event) {
+  byte changed = event.regValue ^ lastRegs[event.group];
+  lastRegs[event.group] = event.regValue;
+  if (changed == 0) return;
+  for (unsigned int portNo=isSetup.next(0); portNo < MaxNoInPCIntPorts; portNo=isSetup.next(portNo+1)) {
+    t_Port &port = ports[portNo];
+    if ((port.group != event.group) || ((changed & port.bitMask) == 0)) continue;
+    port.level = ((event.regValue & port.bitMask) != 0);
+    port.lastEdge = event.time;
+    if ((port.isFiltered == false) && (port.level != port.defaultValue)) port.isPulse = true;
+    byte cnt;
+    for (cnt=0; (cnt < noActive) && (active[cnt] != portNo); cnt++);
+    if (cnt == noActive) active[noActive++] = portNo;
+  }
+}
+
+// Når køen har været fuld, mangler de seneste skift. Registret læses som et nyt skift, så ingen port bliver hængende i et forældet niveau.
+void t_PinChangeInDrv::resync(word now) {
+  PinChange::t_Event event;
+  event.time = now;
+  for (byte group=0; group < PinChange::NoGroups; group++) {
+    if (PinChange::groupRegs[group] == nullptr) continue;
+    event.group = group;
+    event.regValue = *PinChange::groupRegs[group];
+    edge(event);
+  }
+}
+
+// Uden filter leveres en fanget puls i en cyklus, før porten får sit niveau.
+// Med filter skifter porten, når niveauet har været stabilt i ventetiden. Prel tilbage til nuværende værdi afklarer porten.
+bool t_PinChangeInDrv::settle(t_Port &port, word now) {
+  if (port.isFiltered == false) {
+    if (port.isPulse == true) {
+      port.value = !port.defaultValue;
+      port.isPulse = false;
+      return false;
+    }
+    port.value = port.level;
+    return true;
+  }
+  if (port.level == port.value) return true;
+  unsigned int bounceTime = (port.defaultValue == port.value)? port.bounceTimeClose: port.bounceTimeOpen;
+  if ((word)(now-port.lastEdge) < bounceTime) return false;
+  port.value = port.level;
+  return true;
+}
+
+// Kun aktive porte kan skifte værdi. Øjebliksbilledet opdateres derfor kun for dem.
+void t_PinChangeInDrv::doClockCycle() {
+  PinChange::t_Event event;
+  while (PinChange::pop(&event) == true) edge(event);
+  word now = millis();
+  if (PinChange::noLost != lastLost) {
+    lastLost = PinChange::noLost;
+    resync(now);
+  }
+  unsigned long nextInputBits = inputBits;
+  byte cnt = 0;
+  while (cnt < noActive) {
+    byte portNo = active[cnt];
+    bool isSettled = settle(ports[portNo], now);
+    if (portNo < MaxSnapshotPorts) {
+      unsigned long mask = 1UL << portNo;
+      nextInputBits = (ports[portNo].value == HIGH)? (nextInputBits | mask): (nextInputBits & ~mask);
+    }
+    if (isSettled == true) active[cnt] = active[--noActive];
+    else cnt++;
+  }
+  publish(nextInputBits);
+}
+
+bool t_PinChangeInDrv::read(unsigned int portNo, int * /*value*/) {
+  bool result = LOW;
+  if (hasConfig(isSetup, portNo, MaxNoInPCIntPorts) == true) result = ports[portNo].value;
+  return result;
+}
+
+#endif
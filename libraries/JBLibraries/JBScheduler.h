@@ -0,0 +1,134 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Opgavestyring
+ * Version: 1.2
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Opgavestyring".
+ * 
+ * "Opgavestyring" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Opgavestyring" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Opgavestyring".  If not, see <https://www.gnu.org/licenses/>.
+ *  
+ * Noter: 
+ * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Faser regnes fra klokkens tæller af taktslag.
+ * Version 1.2: En opgave der tilføjes i en cyklus før eller under afvikling af opgaverne, afvikles også i sin fase.
+ * Applikationen erklærer MaxNoTasks før biblioteket inkluderes.
+ */
+
+#ifndef JBScheduler_h
+#define JBScheduler_h
+
+#include <Arduino.h>
+#include <JBKernel.h>
+
+// Ansvar: Afvikler opgaver med hver sin periode i forhold til klokkens taktslag.
+// Opgaver med samme periode fordeles på forskellige taktslag, så dyre opgaver ikke lander i samme cyklus.
+// Dermed holdes den længste cyklustid flad, når antallet af komponenter vokser.
+// Faser regnes fra klokkens tæller af taktslag. doClockCycle kaldes i hver cyklus efter Clock::pendulum.
+// AUTOPHASE: Fase vælges automatisk, så belastningen i de enkelte taktslag bliver mindst mulig.
+// MaxPlanCycles: Antal taktslag der ses på ved automatisk valg af fase.
+// t_Task: Opgave med funktion, periode og fase i antal cyklus og relativ pris for afvikling.
+// tasks: Vektor med opgaver. Afvikles i den rækkefølge de er tilføjet.
+// noTasks: Antal opgaver
+// lastTick: Taktslag hvor opgaverne senest er afviklet. En ny opgave afvikles første gang i dette taktslag, hvis det ikke er sket endnu.
+// addTask(...): Tilføjer opgave. Periode og fase er i msek. Returnerer om opgaven er tilføjet.
+// doClockCycle(...): Afvikler de opgaver, der skal køre i dette taktslag.
+namespace Scheduler {
+  enum {AUTOPHASE=0xFFFF};
+  enum {MaxPlanCycles=200};
+  struct t_Task {
+    void (*run)(void);
+    unsigned int period;
+    unsigned int phase;
+    unsigned int countDown;
+    byte cost;
+  };
+  static t_Task tasks[MaxNoTasks];
+  static byte noTasks=0;
+  static unsigned long lastTick=0;
+  bool addTask(void (*run)(void), unsigned int period, byte cost=1, unsigned int phase=AUTOPHASE);
+  void doClockCycle(void);
+  unsigned int loadAt(unsigned int tick);
+  unsigned int choosePhase(unsigned int period);
+}
+
+/*
+ * CPP kode herunder
+ */
+
+// Belastning i et taktslag er summen af prisen for de opgaver, der afvikles i taktslaget
+unsigned int Scheduler::loadAt(unsigned int tick) {
+  unsigned int load = 0;
+  for (byte cnt=0; cnt < noTasks; cnt++) {
+    if ((tick % tasks[cnt].period) == tasks[cnt].phase) load += tasks[cnt].cost;
+  }
+  return load;
+}
+
+// Vælger den fase, hvor den største belastning er mindst. Ved lige store vælges den mindste samlede belastning.
+unsigned int Scheduler::choosePhase(unsigned int period) {
+  unsigned int planCycles = period;
+  unsigned int bestPhase = 0;
+  unsigned int bestMax = 0xFFFF;
+  unsigned int bestSum = 0xFFFF;
+  for (byte cnt=0; cnt < noTasks; cnt++) {
+    if (tasks[cnt].period > planCycles) planCycles = tasks[cnt].period;
+  }
+  if (planCycles > MaxPlanCycles) planCycles = MaxPlanCycles;
+  for (unsigned int phase=0; (phase < period) && (phase < MaxPlanCycles); phase++) {
+    unsigned int maxLoad = 0;
+    unsigned int sumLoad = 0;
+    for (unsigned int tick=phase; tick < planCycles; tick += period) {
+      unsigned int load = loadAt(tick);
+      if (load > maxLoad) maxLoad = load;
+      sumLoad += load;
+    }
+    if ((maxLoad < bestMax) || ((maxLoad == bestMax) && (sumLoad < bestSum))) {
+      bestPhase = phase;
+      bestMax = maxLoad;
+      bestSum = sumLoad;
+    }
+  }
+  return bestPhase;
+}
+
+bool Scheduler::addTask(void (*run)(void), unsigned int period, byte cost, unsigned int phase) {
+  if ((run == nullptr) || (isValidIndex(noTasks, MaxNoTasks) == false)) return false;
+  t_Task &task = tasks[noTasks];
+  task.run = run;
+  task.period = Clock::convertToClockCycles(period);
+  if (task.period == 0) task.period = 1;
+  task.cost = cost;
+  task.phase = (phase == AUTOPHASE)? choosePhase(task.period): Clock::convertToClockCycles(phase) % task.period;
+  unsigned long firstTick = (lastTick == Clock::ticks)? Clock::ticks+1: Clock::ticks;
+  task.countDown = (task.phase + task.period - firstTick % task.period) % task.period;
+  noTasks++;
+  return true;
+}
+
+void Scheduler::doClockCycle(void) {
+  for (byte cnt=0; cnt < noTasks; cnt++) {
+    t_Task &task = tasks[cnt];
+    if (task.countDown == 0) {
+      task.run();
+      task.countDown = task.period;
+    }
+    task.countDown--;
+  }
+  lastTick = Clock::ticks;
+}
+
+#endif
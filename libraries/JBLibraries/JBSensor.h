@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Sensorer
- * Version: 1.0
+ * Version: 1.1
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 07-03-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Sensorer".
  * 
@@ -23,6 +23,7 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Sensor der sammenligner en analog værdi med 2 niveauer med hysterese.
  */
 
 
@@ -72,6 +73,26 @@ public:
   void reset(void);
 };
 
+//----------
+
+// Ansvar: Sensor der sammenligner en analog værdi med 2 niveauer. Afstanden mellem niveauerne er hysterese,
+// så støj omkring et niveau ikke får tilstanden til at skifte frem og tilbage.
+// Er onLevel mindre end offLevel, tændes sensoren under onLevel og slukkes over offLevel. Ellers tændes den over onLevel og slukkes under offLevel.
+// onLevel: Niveau hvor sensoren tændes.
+// offLevel: Niveau hvor sensoren slukkes.
+// setLevels(...): Sætter niveauer.
+// doClockCycle(...): Input driver bliver aflæst i hver klokkescyklus. Mellem niveauerne bevarer sensoren sin tilstand.
+class t_HysteresisSensor: public t_Sensor {
+protected:
+  int onLevel;
+  int offLevel;
+public:
+  t_HysteresisSensor(void): onLevel(0), offLevel(0) {}
+  t_HysteresisSensor(int onLevel, int offLevel): onLevel(onLevel), offLevel(offLevel) {}
+  void setLevels(int onLevel, int offLevel) {this->onLevel = onLevel; this->offLevel = offLevel;}
+  void doClockCycle();
+};
+
 /*
  * CPP kode herunder
  */
@@ -99,4 +120,21 @@ void t_SimpleSensor::reset(void) {
   digitalFunction->reset();
 }
 
+//----------
+
+// Sensor med hysterese
+
+void t_HysteresisSensor::doClockCycle() {
+  int value;
+  if ((driver == nullptr) || (driver->read(portNo, &value) == false)) return;
+  if (onLevel < offLevel) {
+    if (value < onLevel) state = ON;
+    else if (value > offLevel) state = OFF;
+  }
+  else {
+    if (value > onLevel) state = ON;
+    else if (value < offLevel) state = OFF;
+  }
+}
+
 #endif
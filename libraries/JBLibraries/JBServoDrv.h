@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Driver til servomotor
- * Version: 1.0
+ * Version: 1.1
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 25-02-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Driver til servomotor".
  * 
@@ -23,6 +23,7 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Timer til sampling tælles af tidshjulet og stoppes når bevægelsen er slut. Standardværdi for argument er fjernet fra definition af metode write.
  */
 
 #ifndef JBServoDrv_h
@@ -51,6 +52,7 @@ unsigned int servoPeriod = REFRESH_INTERVAL/1000;  // Se kildekode for servo.h
 // sampleTime: Samplingstid i beregning
 // calCoefficient(...): Initialiserer beregninger
 // calcNextPW(...): Udfører beregning og returner næste pulsbredde
+// stop(...): Bevægelsen er slut
 class t_ServoMoveCalculator {
 protected:
   unsigned int sampleTime;
@@ -58,6 +60,7 @@ public:
   t_ServoMoveCalculator(void): sampleTime(1) {}
   virtual int calCoefficient(int fromPW, int toPW, unsigned int deltaTime, unsigned int sampleTime)=0;
   virtual int calcNextPW(void)=0;  
+  virtual void stop(void) {}
 };
 
 //----------
@@ -67,20 +70,22 @@ public:
 // PWSpeed: Pulsbredde ændring per sample
 // currentPW: Nuværende pulsbredde
 // precision: Decimal præcision. Integer * og divider f.eks. 10 giver 1 decimal nøjagtighed
-// sampleTimer: Holder styr på tiden for næste pulsbredde
+// sampleTimer: Holder styr på tiden for næste pulsbredde. Tælles af tidshjulet.
 // calCoefficient(...): Initialiserer beregninger
 // calcNextPW(...): Udfører beregning og returner næste pulsbredde
+// stop(...): Stopper timer
 class t_ServoLinearMove: public t_ServoMoveCalculator {
 private:
   unsigned int sampleTime;
   long PWSpeed;
   long currentPW;
   const int precision = 10;
-  t_SimpleTimer sampleTimer;
+  t_WheelTimer sampleTimer;
 public:
   t_ServoLinearMove(void) {}
   int calCoefficient(int fromPW, int toPW, unsigned int deltaTime, unsigned int sampleTime);
   int calcNextPW(void);
+  void stop(void) {sampleTimer.cancel();}
 };
 
 //----------
@@ -164,7 +169,7 @@ void t_ServoMotor::write(int nextPW) {
   if (isSetup) sendOut(nextPW);
 }
 
-void t_ServoMotor::write(int fromAngle, int toAngle, unsigned int deltaTime, byte timeUnit, unsigned int sampleTime=servoPeriod) {
+void t_ServoMotor::write(int fromAngle, int toAngle, unsigned int deltaTime, byte timeUnit, unsigned int sampleTime) {
   if (!isSetup) return;
   fromPW = map(fromAngle, motorSpecs->AngleMin, motorSpecs->AngleMax, motorSpecs->PulseWidthMin, motorSpecs->PulseWidthMax);
   toPW = map(toAngle, motorSpecs->AngleMin, motorSpecs->AngleMax, motorSpecs->PulseWidthMin, motorSpecs->PulseWidthMax);
@@ -181,6 +186,7 @@ void t_ServoMotor::doClockCycle(void) {
   if (((seq == GOUP) && (nextPW >= toPW)) || ((seq == GODOWN) && (nextPW <= toPW))) {
     nextPW = toPW;
     seq = STABLE;
+    PWCalculator->stop();
   }
   sendOut(nextPW);
 }
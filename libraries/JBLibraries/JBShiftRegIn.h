@@ -0,0 +1,121 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Skifteregister input driver
+ * Version: 1.1
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Skifteregister input driver".
+ *
+ * "Skifteregister input driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Skifteregister input driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Skifteregister input driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.1: Advarsler fra compileren er rettet.
+ * Applikationen erklærer MaxNoInShiftRegs før biblioteket inkluderes.
+ * Skifteregistrene kobles til Arduinos SPI: QH til MISO, SCK til CLK og en pin efter eget valg til SH/LD. CLK INH forbindes til stel.
+ * QH på 74HC165 er altid aktiv. Deles MISO med andre kredse, skal QH kobles via en buffer med tri-state.
+ * Indgangene har ingen intern pullup. Kontakter skal have ekstern pullup eller pulldown.
+ */
+
+#ifndef JBShiftRegIn_h
+#define JBShiftRegIn_h
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <JBKernel.h>
+#include <JBInputDriver.h>
+
+// Ansvar: Indgange på en kæde af 74HC165 skifteregistre, der læses over SPI i en omgang per cyklus.
+// Hvert register har et filter for kontaktprel med lodrette tællere, så filteret koster det samme for 8 indgange som for 1.
+// Port 0-7 er D0-D7 på det første register i kæden, port 8-15 er D0-D7 på det næste osv.
+// NoPorts: Antal indgange i kæden.
+// SpiClock: Clock for SPI. 74HC165 kan klare over 20 MHz ved 5 V. Arduino Uno giver højst 8 MHz.
+// loadPin: Pin til SH/LD. Lav indlæser indgangene i registrene, høj skifter dem ud.
+// inputs: Filter for kontaktprel for hvert register.
+// shiftIn(...): Indlæser indgangene og skifter kæden ind. Det første register i kæden kommer først.
+// begin(...): Opkobler Arduino.
+// setPort(...): Konfigurerer indgangen. En variant kan også sætte tider for kontaktprel.
+// doClockCycle(...): Læser kæden og udfører filter for kontaktprel.
+// read(...): Leverer indgangens nuværende værdi.
+class t_ShiftRegInDrv: public t_InputDriver {
+private:
+  enum {NoPorts=MaxNoInShiftRegs*8};
+  static const uint32_t SpiClock = 8000000;
+  byte loadPin;
+  t_VerticalFilter<byte> inputs[MaxNoInShiftRegs];
+  void shiftIn(byte data[]);
+public:
+  t_ShiftRegInDrv(void) {}
+  void begin(byte loadPin);
+  void setPort(unsigned int portNo, byte ContacType, byte BounceType);
+  void setPort(unsigned int portNo, byte ContacType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose);
+  void doClockCycle();
+  bool read(unsigned int portNo, int *value=nullptr);
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// Kæde af 74HC165 skifteregistre
+
+void t_ShiftRegInDrv::begin(byte loadPin) {
+  this->loadPin = loadPin;
+  digitalWrite(loadPin, HIGH);
+  pinMode(loadPin, OUTPUT);
+  SPI.begin();
+}
+
+// Med SH/LD lav indlæses alle indgange på en gang. Første bit ud er D7 på det første register.
+void t_ShiftRegInDrv::shiftIn(byte data[]) {
+  digitalWrite(loadPin, LOW);
+  digitalWrite(loadPin, HIGH);
+  SPI.beginTransaction(SPISettings(SpiClock, MSBFIRST, SPI_MODE0));
+  for (byte cnt=0; cnt < MaxNoInShiftRegs; cnt++) data[cnt] = SPI.transfer(0);
+  SPI.endTransaction();
+}
+
+void t_ShiftRegInDrv::setPort(unsigned int portNo, byte ContacType, byte BounceType) {
+  setPort(portNo, ContacType, BounceType, 100, 30);
+}
+
+void t_ShiftRegInDrv::setPort(unsigned int portNo, byte ContacType, byte BounceType, unsigned int bounceTimeOpen, unsigned int bounceTimeClose) {
+  byte data[MaxNoInShiftRegs];
+  if (isValidIndex(portNo, NoPorts) == false) return;
+  shiftIn(data);
+  inputs[portNo >> 3].setInput(portNo & 7, ContacType, BounceType, bounceTimeOpen, bounceTimeClose, (data[portNo >> 3] >> (portNo & 7)) & 1);
+}
+
+// Registre uden konfigurerede indgange springes over. De første 32 porte kommer med i øjebliksbilledet.
+void t_ShiftRegInDrv::doClockCycle() {
+  byte data[MaxNoInShiftRegs];
+  unsigned long nextInputBits = 0;
+  shiftIn(data);
+  for (byte cnt=0; cnt < MaxNoInShiftRegs; cnt++) {
+    if (inputs[cnt].configured() == 0) continue;
+    byte value = inputs[cnt].filter(data[cnt]);
+    if (cnt < MaxSnapshotPorts/8) nextInputBits |= (unsigned long)value << (cnt*8);
+  }
+  publish(nextInputBits);
+}
+
+bool t_ShiftRegInDrv::read(unsigned int portNo, int * /*value*/) {
+  bool result = LOW;
+  if (isValidIndex(portNo, NoPorts) == true) result = (inputs[portNo >> 3].dataOut() >> (portNo & 7)) & 1;
+  return result;
+}
+
+#endif
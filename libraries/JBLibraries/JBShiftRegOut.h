@@ -0,0 +1,100 @@
+/*
+ * Projekt: Generelle Arduino biblioteker
+ * Produkt: Skifteregister output driver
+ * Version: 1.2
+ * Type: Bibliotek
+ * Programmeret af: Jan Birch
+ * Opdateret: 17-10-2026
+ * GNU General Public License version 3
+ * This file is part of "Skifteregister output driver".
+ *
+ * "Skifteregister output driver" is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * "Skifteregister output driver" is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with "Skifteregister output driver".  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Noter:
+ * Se koncept og specifikation for en detaljeret beskrivelse af biblioteket, formål og anvendelse.
+ * Version 1.1: Omdøbt fra JBShiftReg.h, da der nu også er en input driver til skifteregistre.
+ * Version 1.2: Advarsler fra compileren er rettet.
+ * Applikationen erklærer MaxNoOutShiftRegs før biblioteket inkluderes.
+ * Skifteregistrene kobles til Arduinos SPI: MOSI til SER, SCK til SRCLK og en pin efter eget valg til RCLK (latch).
+ */
+
+#ifndef JBShiftRegOut_h
+#define JBShiftRegOut_h
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <JBKernel.h>
+#include <JBOutputDriver.h>
+
+// Ansvar: Udgange på en kæde af 74HC595 skifteregistre, der skiftes ud over SPI.
+// Skrivninger ændrer et billede af kæden i RAM. Kæden skiftes kun ud, når billedet er ændret, og højst en gang per cyklus.
+// Uden ændringer koster en cyklus derfor kun et tjek af et flag.
+// Port 0-7 er Q0-Q7 på det første register i kæden, port 8-15 er Q0-Q7 på det næste osv.
+// NoPorts: Antal udgange i kæden.
+// SpiClock: Clock for SPI. 74HC595 kan klare over 20 MHz ved 5 V. Arduino Uno giver højst 8 MHz.
+// latchPin: Pin til RCLK. Udgangene skifter samtidigt, når RCLK går høj.
+// image: Billede af kæden. En byte per register.
+// isDirty: Om billedet er ændret, siden kæden sidst blev skiftet ud.
+// begin(...): Opkobler Arduino og skifter et billede med alle udgange lave ud.
+// write(...): Skriver værdi i billedet.
+// doClockCycle(...): Skifter kæden ud, hvis billedet er ændret. Kaldes sidst i cyklus.
+class t_ShiftRegOutDrv: public t_OutputDriver {
+private:
+  enum {NoPorts=MaxNoOutShiftRegs*8};
+  static const uint32_t SpiClock = 8000000;
+  byte latchPin;
+  byte image[MaxNoOutShiftRegs];
+  bool isDirty;
+  void shiftOut(void);
+public:
+  t_ShiftRegOutDrv(void): isDirty(false) {for (byte cnt=0; cnt < MaxNoOutShiftRegs; cnt++) image[cnt] = 0;}
+  void begin(byte latchPin);
+  void write(unsigned int portNo, bool value);
+  void doClockCycle(void) {if (isDirty == true) shiftOut();}
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// Kæde af 74HC595 skifteregistre
+
+void t_ShiftRegOutDrv::begin(byte latchPin) {
+  this->latchPin = latchPin;
+  digitalWrite(latchPin, LOW);
+  pinMode(latchPin, OUTPUT);
+  SPI.begin();
+  shiftOut();
+}
+
+void t_ShiftRegOutDrv::write(unsigned int portNo, bool value) {
+  if (isValidIndex(portNo, NoPorts) == false) return;
+  byte mask = 1 << (portNo & 7);
+  byte next = (value == LOW)? (image[portNo >> 3] & ~mask): (image[portNo >> 3] | mask);
+  if (next == image[portNo >> 3]) return;
+  image[portNo >> 3] = next;
+  isDirty = true;
+}
+
+// Den første byte ender i det sidste register. Derfor skiftes billedet ud bagfra.
+void t_ShiftRegOutDrv::shiftOut(void) {
+  SPI.beginTransaction(SPISettings(SpiClock, MSBFIRST, SPI_MODE0));
+  for (int cnt=MaxNoOutShiftRegs-1; cnt >= 0; cnt--) SPI.transfer(image[cnt]);
+  SPI.endTransaction();
+  digitalWrite(latchPin, HIGH);
+  digitalWrite(latchPin, LOW);
+  isDirty = false;
+}
+
+#endif
@@ -1,10 +1,10 @@
 /*
  * Projekt: Generelle Arduino biblioteker
  * Produkt: Tilstandsmaskine
- * Version: 1.0
+ * Version: 1.2
  * Type: Bibliotek
  * Programmeret af: Jan Birch
- * Opdateret: 08-03-2023
+ * Opdateret: 17-10-2026
  * GNU General Public License version 3
  * This file is part of "Tilstandsmaskine".
  * 
@@ -23,6 +23,8 @@
  *  
  * Noter: 
  * Se koncept og specifikation for en detaljeret beskrivelse af programmet, formål og anvendelse.
+ * Version 1.1: Timer til tidsstyret overgang tælles af tidshjulet.
+ * Version 1.2: Tilstandsmaskine styret af tabeller i program memory.
  */
 
 #ifndef JBStateMachine_h
@@ -30,15 +32,16 @@
 
 #include <Arduino.h>
 #include <JBKernel.h>
+#include <avr/pgmspace.h>
 
 // Ansvar: Er grænseflade til tilstandsmaskine.
-// transitTimer: Bruges af tilstand, med tidsstyret overgang til næste tilstand.
+// transitTimer: Bruges af tilstand, med tidsstyret overgang til næste tilstand. Tælles af tidshjulet.
 // onEntry(...): Udfører funktioner for ankomst til en "state"..
 // doCondition(...): Svarer på om betingelser for overgang til næste tilstand er opfyldt.
 // onExit(...): Udfører funktioner for afgang fra en "state".
 class t_StateMachine {
 protected:
-  static t_SimpleTimer transitTimer;
+  static t_WheelTimer transitTimer;
 public:
   t_StateMachine(void) {}
   virtual void onEntry(void) {}
@@ -46,6 +49,118 @@ public:
   virtual void onExit(void) {}  
 };
 
-t_SimpleTimer t_StateMachine::transitTimer;
+t_WheelTimer t_StateMachine::transitTimer;
+
+//----------
+
+// Ansvar: Overgang i en tabel for tilstandsmaskine. Betingelsen er opfyldt, når signalerne i mask har værdierne i value.
+// fromState: Tilstand overgangen gælder for.
+// toState: Næste tilstand.
+// mask: Signaler der indgår i betingelsen.
+// value: Signalernes værdi for overgang.
+struct t_Transition {
+  byte fromState;
+  byte toState;
+  unsigned long mask;
+  unsigned long value;
+};
+
+// Ansvar: Funktioner for ankomst og afgang i en tabel for tilstandsmaskine. Indeks i tabellen er tilstanden.
+// onEntry: Kaldes ved ankomst til tilstanden. Kan være nullptr.
+// onExit: Kaldes ved afgang fra tilstanden. Kan være nullptr.
+struct t_StateActions {
+  void (*onEntry)(void);
+  void (*onExit)(void);
+};
+
+//----------
+
+// Ansvar: Tilstandsmaskine styret af tabeller i program memory. Tabellerne erklæres constexpr med PROGMEM.
+// Applikationen samler betjeninger og sensorer i et ord med et signal per bit, og betingelser er masker på ordet.
+// Betingelser beregnes kun ved ankomst til en tilstand og i cyklusser, hvor et signal i tilstandens betingelser har skiftet.
+// Overgange for en tilstand står samlet i tabellen. Den første opfyldte betingelse vælges, som i en kæde af if.
+// Forløbet er det samme som i mediatoren: Ankomst sker i cyklussen efter overgangen, og betingelser beregnes i samme cyklus.
+// Tidsstyret overgang laves med et signal fra f.eks. en tidsfunktion.
+// transitions: Tabel med overgange.
+// noTransitions: Antal overgange.
+// actions: Tabel med funktioner for ankomst og afgang.
+// stateNo: Nuværende tilstand.
+// first: Tilstandens første overgang.
+// stateMask: Alle signaler i tilstandens betingelser.
+// signals: Signaler fra seneste cyklus.
+// entryState: Ankomst til tilstanden er ikke udført.
+// enter(...): Udfører ankomst og finder tilstandens overgange.
+// begin(...): Initialiserer tabeller og den første tilstand.
+// doClockCycle(...): Beregner betingelser ved ankomst eller skift af signaler og udfører overgang.
+// status(...): Leverer nuværende tilstand.
+class t_TableStateMachine {
+private:
+  const t_Transition *transitions;
+  byte noTransitions;
+  const t_StateActions *actions;
+  byte stateNo;
+  byte first;
+  unsigned long stateMask;
+  unsigned long signals;
+  bool entryState;
+  void enter(void);
+public:
+  t_TableStateMachine(void): transitions(nullptr), noTransitions(0), actions(nullptr), stateNo(0), first(0), stateMask(0), signals(0), entryState(false) {}
+  void begin(const t_Transition *transitions, byte noTransitions, const t_StateActions *actions, byte stateNo);
+  void doClockCycle(unsigned long signals);
+  byte status(void) const {return stateNo;}
+};
+
+/*
+ * CPP kode herunder
+ */
+
+// Tilstandsmaskine styret af tabeller
+
+void t_TableStateMachine::begin(const t_Transition *transitions, byte noTransitions, const t_StateActions *actions, byte stateNo) {
+  this->transitions = transitions;
+  this->noTransitions = noTransitions;
+  this->actions = actions;
+  this->stateNo = stateNo;
+  entryState = true;
+}
+
+// Tabellen gennemløbes kun ved ankomst til en tilstand
+void t_TableStateMachine::enter(void) {
+  t_StateActions stateActions;
+  t_Transition transition;
+  memcpy_P(&stateActions, &actions[stateNo], sizeof(stateActions));
+  if (stateActions.onEntry != nullptr) stateActions.onEntry();
+  for (first=0; first < noTransitions; first++) {
+    if (pgm_read_byte(&transitions[first].fromState) == stateNo) break;
+  }
+  stateMask = 0;
+  for (byte cnt=first; cnt < noTransitions; cnt++) {
+    memcpy_P(&transition, &transitions[cnt], sizeof(transition));
+    if (transition.fromState != stateNo) break;
+    stateMask |= transition.mask;
+  }
+  entryState = false;
+}
+
+void t_TableStateMachine::doClockCycle(unsigned long signals) {
+  bool isChanged = ((this->signals ^ signals) & stateMask) != 0;
+  t_Transition transition;
+  this->signals = signals;
+  if (entryState == true) enter();
+  else if (isChanged == false) return;
+  for (byte cnt=first; cnt < noTransitions; cnt++) {
+    memcpy_P(&transition, &transitions[cnt], sizeof(transition));
+    if (transition.fromState != stateNo) return;
+    if ((signals & transition.mask) == transition.value) {
+      t_StateActions stateActions;
+      memcpy_P(&stateActions, &actions[stateNo], sizeof(stateActions));
+      if (stateActions.onExit != nullptr) stateActions.onExit();
+      stateNo = transition.toState;
+      entryState = true;
+      return;
+    }
+  }
+}
 
 #endif